@@ -0,0 +1,501 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <mp/inplace_string.h>
+#include <mp/inplace_string_algorithm.h>
+#include <mp/inplace_string_format.h>
+#include <mp/inplace_string_stream.h>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Benchmark matrix: MaxSize x fill ratio x operation x string type.
+// Results may be stored in JSON with '--benchmark_out=<file> --benchmark_out_format=json'.
+
+namespace {
+
+  // baseline: what a C programmer would write
+  template<std::size_t N>
+  struct char_array {
+    char data[N + 1];
+  };
+
+  template<typename T>
+  struct is_char_array : std::false_type {
+  };
+  template<std::size_t N>
+  struct is_char_array<char_array<N>> : std::true_type {
+  };
+
+  template<typename S>
+  constexpr bool is_mutable = !std::is_same_v<S, std::string_view>;
+
+  template<typename S>
+  S make(std::string_view sv)
+  {
+    if constexpr(is_char_array<S>::value) {
+      S s;
+      std::memcpy(s.data, sv.data(), sv.size());
+      s.data[sv.size()] = '\0';
+      return s;
+    }
+    else
+      return S(sv);
+  }
+
+  template<typename S>
+  std::string_view view(const S& s)
+  {
+    if constexpr(is_char_array<S>::value)
+      return std::string_view(s.data);
+    else
+      return std::string_view(s);
+  }
+
+  template<typename S>
+  void assign(S& s, std::string_view sv)
+  {
+    if constexpr(is_char_array<S>::value) {
+      std::memcpy(s.data, sv.data(), sv.size());
+      s.data[sv.size()] = '\0';
+    }
+    else
+      s.assign(sv);
+  }
+
+  template<typename S>
+  void append(S& s, std::string_view sv)
+  {
+    if constexpr(is_char_array<S>::value) {
+      const auto size = std::strlen(s.data);
+      std::memcpy(s.data + size, sv.data(), sv.size());
+      s.data[size + sv.size()] = '\0';
+    }
+    else
+      s.append(sv);
+  }
+
+  template<typename S>
+  void push_back(S& s, char c)
+  {
+    if constexpr(is_char_array<S>::value) {
+      const auto size = std::strlen(s.data);
+      s.data[size] = c;
+      s.data[size + 1] = '\0';
+    }
+    else
+      s.push_back(c);
+  }
+
+  template<typename S>
+  int compare(const S& lhs, const S& rhs)
+  {
+    if constexpr(is_char_array<S>::value)
+      return std::strcmp(lhs.data, rhs.data);
+    else
+      return lhs.compare(rhs);
+  }
+
+  template<typename S>
+  std::size_t find(const S& s, char c)
+  {
+    if constexpr(is_char_array<S>::value) {
+      const char* ptr = std::strchr(s.data, c);
+      return ptr ? static_cast<std::size_t>(ptr - s.data) : std::string_view::npos;
+    }
+    else
+      return s.find(c);
+  }
+
+  template<typename S>
+  std::size_t hash(const S& s)
+  {
+    if constexpr(is_char_array<S>::value)
+      return std::hash<std::string_view>{}(s.data);
+    else
+      return std::hash<S>{}(s);
+  }
+
+  // content of the requested length differing only at the last character
+  std::string text(std::size_t length, char last = 'z')
+  {
+    std::string str(length, 'a');
+    if(length) str.back() = last;
+    return str;
+  }
+
+  template<typename S>
+  void bm_construct(benchmark::State& state, std::size_t length)
+  {
+    const auto src = text(length);
+    for(auto _ : state) {
+      std::string_view sv = src;
+      benchmark::DoNotOptimize(sv);
+      auto s = make<S>(sv);
+      benchmark::DoNotOptimize(s);
+    }
+  }
+
+  template<typename S>
+  void bm_assign(benchmark::State& state, std::size_t length)
+  {
+    const auto src = text(length);
+    auto s = make<S>("");
+    for(auto _ : state) {
+      std::string_view sv = src;
+      benchmark::DoNotOptimize(sv);
+      assign(s, sv);
+      benchmark::DoNotOptimize(s);
+    }
+  }
+
+  template<typename S>
+  void bm_append(benchmark::State& state, std::size_t length)
+  {
+    const auto src = text(length);
+    const std::string_view head = std::string_view(src).substr(0, length / 2);
+    const std::string_view tail = std::string_view(src).substr(length / 2);
+    for(auto _ : state) {
+      auto s = make<S>(head);
+      append(s, tail);
+      benchmark::DoNotOptimize(s);
+    }
+  }
+
+  template<typename S>
+  void bm_push_back(benchmark::State& state, std::size_t length)
+  {
+    for(auto _ : state) {
+      auto s = make<S>("");
+      for(std::size_t i = 0; i < length; ++i) push_back(s, 'a');
+      benchmark::DoNotOptimize(s);
+    }
+  }
+
+  template<typename S>
+  void bm_compare(benchmark::State& state, std::size_t length)
+  {
+    const auto lhs_src = text(length, 'y');
+    const auto rhs_src = text(length, 'z');
+    const auto lhs = make<S>(lhs_src);
+    const auto rhs = make<S>(rhs_src);
+    for(auto _ : state) benchmark::DoNotOptimize(compare(lhs, rhs));
+  }
+
+  template<typename S>
+  void bm_copy(benchmark::State& state, std::size_t length)
+  {
+    const auto src = text(length);
+    const auto s = make<S>(src);
+    for(auto _ : state) {
+      auto copy = s;
+      benchmark::DoNotOptimize(copy);
+    }
+  }
+
+  template<typename S>
+  void bm_swap(benchmark::State& state, std::size_t length)
+  {
+    const auto lhs_src = text(length, 'y');
+    const auto rhs_src = text(length, 'z');
+    auto lhs = make<S>(lhs_src);
+    auto rhs = make<S>(rhs_src);
+    for(auto _ : state) {
+      using std::swap;
+      swap(lhs, rhs);
+      benchmark::DoNotOptimize(lhs);
+      benchmark::DoNotOptimize(rhs);
+    }
+  }
+
+  template<typename S>
+  void bm_hash(benchmark::State& state, std::size_t length)
+  {
+    const auto src = text(length);
+    const auto s = make<S>(src);
+    for(auto _ : state) benchmark::DoNotOptimize(hash(s));
+  }
+
+  template<typename S>
+  void bm_find(benchmark::State& state, std::size_t length)
+  {
+    const auto src = text(length);
+    const auto s = make<S>(src);
+    for(auto _ : state) benchmark::DoNotOptimize(find(s, 'z'));
+  }
+
+  template<typename S>
+  void register_type(const std::string& type, std::size_t max_size)
+  {
+    for(const std::size_t ratio : {0, 25, 50, 100}) {
+      const std::size_t length = max_size * ratio / 100;
+      std::string name = "/" + type;
+      if constexpr(std::is_same_v<S, std::string>) name += length > std::string{}.capacity() ? "(heap)" : "(sso)";
+      name += "/max_size:" + std::to_string(max_size) + "/fill:" + std::to_string(ratio);
+
+      const auto reg = [&](const char* op, void (*fn)(benchmark::State&, std::size_t)) {
+        benchmark::RegisterBenchmark((op + name).c_str(), fn, length);
+      };
+      reg("construct", bm_construct<S>);
+      reg("copy", bm_copy<S>);
+      reg("swap", bm_swap<S>);
+      reg("compare", bm_compare<S>);
+      reg("hash", bm_hash<S>);
+      reg("find", bm_find<S>);
+      if constexpr(is_mutable<S>) {
+        reg("assign", bm_assign<S>);
+        reg("append", bm_append<S>);
+        reg("push_back", bm_push_back<S>);
+      }
+    }
+  }
+
+  // table scan: one needle against many strings of pseudo-random lengths of which about every 16th is equal to it
+  template<std::size_t MaxSize>
+  std::vector<mp::inplace_string<MaxSize>> scan_table(std::string_view needle)
+  {
+    std::vector<mp::inplace_string<MaxSize>> v(100'000);
+    std::uint32_t seed = 1;
+    for(auto& s : v) {
+      seed = seed * 1664525u + 1013904223u;
+      s = seed >> 28 ? text((seed >> 8) % (MaxSize + 1), 'y') : std::string{needle};
+    }
+    return v;
+  }
+
+  template<std::size_t MaxSize>
+  void bm_scan_equal(benchmark::State& state)
+  {
+    const auto needle = text(MaxSize / 2);
+    const auto v = scan_table<MaxSize>(needle);
+    std::vector<std::uint64_t> bitmask((v.size() + 63) / 64);
+    for(auto _ : state) {
+      for(std::size_t base = 0; base < v.size(); base += 64) {
+        std::uint64_t word = 0;
+        for(std::size_t j = 0; j < 64 && base + j < v.size(); ++j) word |= std::uint64_t{v[base + j] == needle} << j;
+        bitmask[base / 64] = word;
+      }
+      benchmark::DoNotOptimize(bitmask.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * v.size()));
+  }
+
+  template<std::size_t MaxSize>
+  void bm_scan_match_all(benchmark::State& state)
+  {
+    const auto needle = text(MaxSize / 2);
+    const auto v = scan_table<MaxSize>(needle);
+    std::vector<std::uint64_t> bitmask((v.size() + 63) / 64);
+    for(auto _ : state)
+      benchmark::DoNotOptimize(mp::match_all(std::string_view{needle}, v.begin(), v.end(), bitmask.data()));
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * v.size()));
+  }
+
+  // message encoding: 20 integers of various magnitudes appended to one string
+  template<bool ToString>
+  void bm_append_ints(benchmark::State& state)
+  {
+    std::vector<long long> values;
+    for(long long v = 7, i = 0; i < 20; ++i, v = v * 37 % 1'000'000'007) values.push_back(i % 5 ? v : -v);
+    for(auto _ : state) {
+      mp::inplace_string<255> msg;
+      for(const auto v : values) {
+        if constexpr(ToString)
+          msg.append(std::to_string(v));
+        else
+          msg.append_int(v);
+        msg.push_back('|');
+      }
+      benchmark::DoNotOptimize(msg);
+    }
+  }
+
+  // market data: 20 prices appended to one string
+  template<bool Stream>
+  void bm_append_floats(benchmark::State& state)
+  {
+    std::vector<double> values;
+    for(int i = 0; i < 20; ++i) values.push_back(100.0 + i * 0.25 + (i % 3) * 0.01);
+    for(auto _ : state) {
+      mp::inplace_string<255> msg;
+      if constexpr(Stream) {
+        std::ostringstream os;
+        for(const auto v : values) os << v << '|';
+        msg = os.str();
+      }
+      else {
+        for(const auto v : values) {
+          msg.append_float(v);
+          msg.push_back('|');
+        }
+      }
+      benchmark::DoNotOptimize(msg);
+    }
+  }
+
+  // order parsing: 10 numeric fields (integers and prices) converted to numbers
+  template<bool Std>
+  void bm_parse_fields(benchmark::State& state)
+  {
+    const std::vector<mp::inplace_string<31>> fields{"1234567", "20240117", "-42", "987654321012", "7",
+                                                     "101.25", "0.0375", "-12.5", "99999.999", "1e-3"};
+    for(auto _ : state) {
+      long long ints = 0;
+      double floats = 0;
+      for(std::size_t i = 0; i < fields.size(); ++i) {
+        if constexpr(Std) {
+          if(i < 5)
+            ints += std::stoll(std::string{fields[i]});
+          else
+            floats += std::stod(std::string{fields[i]});
+        }
+        else {
+          if(i < 5)
+            ints += fields[i].parse<long long>().value;
+          else
+            floats += fields[i].parse<double>().value;
+        }
+      }
+      benchmark::DoNotOptimize(ints);
+      benchmark::DoNotOptimize(floats);
+    }
+  }
+
+  // text input: 100 lines read with getline()
+  template<bool Std>
+  void bm_getline(benchmark::State& state)
+  {
+    std::string text;
+    for(int i = 0; i < 100; ++i) text += "2024-01-17 12:00:" + std::to_string(i % 60) + " order AAPL 101.25 300\n";
+    std::istringstream is;
+    std::conditional_t<Std, std::string, mp::inplace_string<63>> line;
+    for(auto _ : state) {
+      is.str(text);
+      is.clear();
+      std::size_t total = 0;
+      while(getline(is, line)) total += line.size();
+      benchmark::DoNotOptimize(total);
+    }
+  }
+
+  // text output: a message with a few fields written with operator<< through a new stream
+  template<bool Std>
+  void bm_ostream(benchmark::State& state)
+  {
+    const mp::inplace_string<15> symbol{"AAPL"};
+    int quantity = 300;
+    for(auto _ : state) {
+      benchmark::DoNotOptimize(quantity);
+      if constexpr(Std) {
+        std::ostringstream os;
+        os << "order " << symbol << " qty=" << quantity << " side=" << 'B';
+        benchmark::DoNotOptimize(os.str());
+      }
+      else {
+        mp::inplace_string<63> line;
+        {
+          mp::inplace_ostringstream<63> os{line};
+          os << "order " << symbol << " qty=" << quantity << " side=" << 'B';
+        }
+        benchmark::DoNotOptimize(line);
+      }
+    }
+  }
+
+#if defined(MP_INPLACE_STRING_FORMAT)
+  // logging: one line with a few fields formatted into a fixed-size buffer
+  template<bool Snprintf>
+  void bm_log_line(benchmark::State& state)
+  {
+    const mp::inplace_string<15> symbol{"AAPL"};
+    double price = 101.25;
+    int quantity = 300;
+    for(auto _ : state) {
+      benchmark::DoNotOptimize(price);
+      benchmark::DoNotOptimize(quantity);
+      if constexpr(Snprintf) {
+        char line[128];
+        std::snprintf(line, sizeof(line), "order %s px=%.2f qty=%d side=%c", symbol.c_str(), price, quantity, 'B');
+        benchmark::DoNotOptimize(line);
+      }
+      else {
+        mp::inplace_string<127> line;
+        mp::format_to(line, "order {} px={:.2f} qty={} side={}", symbol, price, quantity, 'B');
+        benchmark::DoNotOptimize(line);
+      }
+    }
+  }
+#endif
+
+  template<std::size_t MaxSize>
+  void register_max_size()
+  {
+    register_type<mp::inplace_string<MaxSize>>("inplace_string", MaxSize);
+    register_type<mp::bounded_copy_inplace_string<MaxSize>>("bounded_copy_inplace_string", MaxSize);
+    register_type<std::string>("std::string", MaxSize);
+    register_type<std::string_view>("std::string_view", MaxSize);
+    register_type<char_array<MaxSize>>("char[]", MaxSize);
+
+    const auto scan = "/inplace_string/max_size:" + std::to_string(MaxSize);
+    benchmark::RegisterBenchmark(("scan_operator==" + scan).c_str(), bm_scan_equal<MaxSize>);
+    benchmark::RegisterBenchmark(("scan_match_all" + scan).c_str(), bm_scan_match_all<MaxSize>);
+  }
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  register_max_size<8>();
+  register_max_size<16>();
+  register_max_size<32>();
+  register_max_size<64>();
+  register_max_size<255>();
+  register_max_size<1024>();
+  register_max_size<4096>();
+  benchmark::RegisterBenchmark("append_ints/std::to_string", bm_append_ints<true>);
+  benchmark::RegisterBenchmark("append_ints/append_int", bm_append_ints<false>);
+  benchmark::RegisterBenchmark("append_floats/std::ostringstream", bm_append_floats<true>);
+  benchmark::RegisterBenchmark("append_floats/append_float", bm_append_floats<false>);
+  benchmark::RegisterBenchmark("parse_fields/std::stoll+std::stod", bm_parse_fields<true>);
+  benchmark::RegisterBenchmark("parse_fields/parse", bm_parse_fields<false>);
+  benchmark::RegisterBenchmark("getline/std::string", bm_getline<true>);
+  benchmark::RegisterBenchmark("getline/inplace_string", bm_getline<false>);
+  benchmark::RegisterBenchmark("ostream/std::ostringstream", bm_ostream<true>);
+  benchmark::RegisterBenchmark("ostream/inplace_ostringstream", bm_ostream<false>);
+#if defined(MP_INPLACE_STRING_FORMAT)
+  benchmark::RegisterBenchmark("log_line/snprintf", bm_log_line<true>);
+  benchmark::RegisterBenchmark("log_line/mp::format_to", bm_log_line<false>);
+#endif
+
+  benchmark::Initialize(&argc, argv);
+  if(benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+}
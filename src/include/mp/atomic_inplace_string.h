@@ -0,0 +1,197 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_string.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+namespace mp {
+
+  namespace detail {
+
+    namespace atomic_storage {
+
+      // objects of up to 8 bytes: one lock-free atomic word
+      template<std::size_t Bytes>
+      class word {
+        std::atomic<std::uint64_t> value_{0};
+
+      public:
+        static constexpr bool is_always_lock_free = std::atomic<std::uint64_t>::is_always_lock_free;
+
+        void load(void* out) const noexcept
+        {
+          const auto v = value_.load(std::memory_order_acquire);
+          std::memcpy(out, &v, Bytes);
+        }
+        void store(const void* in) noexcept
+        {
+          std::uint64_t v = 0;
+          std::memcpy(&v, in, Bytes);
+          value_.store(v, std::memory_order_release);
+        }
+      };
+
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+      // objects of up to 16 bytes on targets with cmpxchg16b (e.g. x86-64 with -mcx16); loads are a compare and swap
+      // with equal old and new values
+      template<std::size_t Bytes>
+      class double_word {
+        __extension__ using value_type = unsigned __int128;
+        alignas(16) value_type value_ = 0;
+
+      public:
+        static constexpr bool is_always_lock_free = true;
+
+        void load(void* out) const noexcept
+        {
+          const auto v = __sync_val_compare_and_swap(const_cast<value_type*>(&value_), value_type{0}, value_type{0});
+          std::memcpy(out, &v, Bytes);
+        }
+        void store(const void* in) noexcept
+        {
+          value_type v = 0;
+          std::memcpy(&v, in, Bytes);
+          value_type expected = 0;
+          for(value_type old; (old = __sync_val_compare_and_swap(&value_, expected, v)) != expected;) expected = old;
+        }
+      };
+#endif
+
+      // Sequence lock: a writer makes the counter odd, stores the words and makes it even again; readers retry
+      // whenever the counter was odd or changed during their copy. Readers never write to shared memory.
+      template<std::size_t Bytes>
+      class seqlock {
+        static constexpr std::size_t words = (Bytes + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+        std::atomic<std::uint32_t> seq_{0};
+        std::atomic<std::uint64_t> value_[words] = {};
+
+      public:
+        static constexpr bool is_always_lock_free = false;
+
+        void load(void* out) const noexcept
+        {
+          std::uint64_t buffer[words];
+          for(;;) {
+            const auto before = seq_.load(std::memory_order_acquire);
+            if(before & 1) {
+              std::this_thread::yield();
+              continue;
+            }
+            for(std::size_t i = 0; i < words; ++i) buffer[i] = value_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(seq_.load(std::memory_order_relaxed) == before) break;
+          }
+          std::memcpy(out, buffer, Bytes);
+        }
+        // concurrent writers are serialized on the counter
+        void store(const void* in) noexcept
+        {
+          std::uint64_t buffer[words] = {};
+          std::memcpy(buffer, in, Bytes);
+          auto seq = seq_.load(std::memory_order_relaxed);
+          while((seq & 1) || !seq_.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire)) {
+            if(seq & 1) {
+              std::this_thread::yield();
+              seq = seq_.load(std::memory_order_relaxed);
+            }
+          }
+          std::atomic_thread_fence(std::memory_order_release);
+          for(std::size_t i = 0; i < words; ++i) value_[i].store(buffer[i], std::memory_order_relaxed);
+          seq_.store(seq + 2, std::memory_order_release);
+        }
+      };
+
+      template<std::size_t Bytes>
+      using select = std::conditional_t<(Bytes <= 8), word<Bytes>,
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+                                        std::conditional_t<(Bytes <= 16), double_word<Bytes>, seqlock<Bytes>>
+#else
+                                        seqlock<Bytes>
+#endif
+                                        >;
+
+    }  // namespace atomic_storage
+
+  }  // namespace detail
+
+  // Atomic basic_inplace_string value for sharing small mutable strings between threads. Strings of up to 8 bytes
+  // use a lock-free atomic word, up to 16 bytes a 16-byte compare and swap where available and the bigger ones a
+  // sequence lock. In every case readers never block on a lock.
+  template<typename Str>
+  class basic_atomic_inplace_string {
+    static_assert(is_trivially_relocatable_v<Str>, "Strings have to be trivially relocatable");
+    using storage_type = detail::atomic_storage::select<sizeof(Str)>;
+
+  public:
+    using value_type = Str;
+    using string_view_type = std::basic_string_view<typename Str::value_type, typename Str::traits_type>;
+
+    static constexpr bool is_always_lock_free = storage_type::is_always_lock_free;
+
+    basic_atomic_inplace_string() noexcept { store(Str{}); }
+    basic_atomic_inplace_string(const Str& str) noexcept { store(str); }
+    basic_atomic_inplace_string(const basic_atomic_inplace_string&) = delete;
+    basic_atomic_inplace_string& operator=(const basic_atomic_inplace_string&) = delete;
+
+    bool is_lock_free() const noexcept { return is_always_lock_free; }
+
+    Str load() const noexcept
+    {
+      alignas(Str) unsigned char buffer[sizeof(Str)];
+      storage_.load(buffer);
+      Str str;
+      std::memcpy(static_cast<void*>(&str), buffer, sizeof(Str));
+      return str;
+    }
+    operator Str() const noexcept { return load(); }
+
+    void store(const Str& str) noexcept { storage_.store(&str); }
+    // throws according to the overflow policy of 'Str' when 'str' does not fit in it
+    template<typename K, detail::Requires<std::is_convertible<const K&, string_view_type>,
+                                          std::negation<std::is_same<K, Str>>> = true>
+    void store(const K& str)
+    {
+      store(Str{string_view_type{str}});
+    }
+    basic_atomic_inplace_string& operator=(const Str& str) noexcept
+    {
+      store(str);
+      return *this;
+    }
+
+  private:
+    storage_type storage_;
+  };
+
+  // aliases
+  template<std::size_t MaxSize>
+  using atomic_inplace_string = basic_atomic_inplace_string<inplace_string<MaxSize>>;
+
+}  // namespace mp
@@ -22,13 +22,53 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cfloat>
+#include <charconv>
 #include <cstdint>
+#include <cstring>
+#include <functional>
 #include <iterator>
 #include <limits>
+#include <memory>
+#include <new>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+// SIMD kernels are selected at compile time from the target architecture flags
+// (define MP_INPLACE_STRING_NO_SIMD to always use the portable implementation)
+#if !defined(MP_INPLACE_STRING_NO_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MP_INPLACE_STRING_SSE2 1
+#endif
+#if defined(__AVX2__)
+#define MP_INPLACE_STRING_AVX2 1
+#endif
+#endif
+
+#if defined(__cpp_impl_three_way_comparison) && __has_include(<compare>)
+#include <compare>
+#endif
+#if defined(__cpp_lib_three_way_comparison)
+#define MP_INPLACE_STRING_THREE_WAY_COMPARISON 1
+#endif
+// floating-point std::to_chars() and std::from_chars() are needed for append_float() and from_chars() of
+// floating-point values
+#if defined(__cpp_lib_to_chars)
+#define MP_INPLACE_STRING_FLOAT_TO_CHARS 1
+#endif
+
+#if defined(MP_INPLACE_STRING_SSE2)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace mp {
 
@@ -39,13 +79,1024 @@ namespace mp {
     template<size_t Size>
     using impl_size_type_helper =
         std::conditional_t<Size == 1, std::uint8_t, std::conditional_t<Size == 2, std::uint16_t, std::uint32_t>>;
+
+    // the smallest unsigned type able to store 'Value'
+    template<std::uint64_t Value>
+    using uint_least_t = std::conditional_t<
+        Value <= 0xffu, std::uint8_t,
+        std::conditional_t<Value <= 0xffffu, std::uint16_t,
+                           std::conditional_t<Value <= 0xffffffffu, std::uint32_t, std::uint64_t>>>;
+
+    // gives free functions access to the whole storage (characters and the size) of basic_inplace_string
+    struct inplace_string_access {
+      template<typename Str>
+      static constexpr std::size_t storage_size() noexcept
+      {
+        return std::tuple_size<decltype(Str::chars_)>::value;
+      }
+      template<typename Str>
+      static constexpr auto storage(const Str& str) noexcept
+      {
+        return str.chars_.data();
+      }
+      // position (in characters) of the first character within the storage
+      template<typename Str>
+      static constexpr std::size_t data_offset() noexcept
+      {
+        return Str::data_offset;
+      }
+      // sets the size of a string which characters were already written to data()
+      template<typename Str>
+      static constexpr void size(Str& str, std::size_t s) noexcept
+      {
+        str.size(static_cast<typename Str::size_type>(s));
+      }
+    };
+
+    template<typename T>
+    struct type_identity {
+      using type = T;
+    };
+    template<typename T>
+    using type_identity_t = typename type_identity<T>::type;
+
+#if defined(MP_INPLACE_STRING_THREE_WAY_COMPARISON)
+    template<typename Traits, typename = void>
+    struct comparison_category {
+      using type = std::weak_ordering;
+    };
+    template<typename Traits>
+    struct comparison_category<Traits, std::void_t<typename Traits::comparison_category>> {
+      using type = typename Traits::comparison_category;
+    };
+    template<typename Traits>
+    using comparison_category_t = typename comparison_category<Traits>::type;
+#endif
+
+    constexpr bool is_constant_evaluated() noexcept
+    {
+#if defined(__cpp_lib_is_constant_evaluated)
+      return std::is_constant_evaluated();
+#elif defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+      return __builtin_is_constant_evaluated();
+#else
+      return false;
+#endif
+#else
+      return false;
+#endif
+    }
+
+    // true for the code units continuing a code point started by the preceding ones (UTF-8 and UTF-16)
+    template<typename CharT>
+    constexpr bool is_continuation(CharT c) noexcept
+    {
+      if constexpr(sizeof(CharT) == 1)
+        return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+      else if constexpr(sizeof(CharT) == 2)
+        return (static_cast<std::uint16_t>(c) & 0xFC00) == 0xDC00;
+      else
+        return false;
+    }
+
+    // number of the first 'n' characters of 's' that do not end in the middle of a UTF-8 (UTF-16 for 2-byte
+    // characters) code point
+    template<typename CharT>
+    constexpr std::size_t complete_code_points(const CharT* s, std::size_t n) noexcept
+    {
+      std::size_t lead = n;
+      while(lead > 0 && is_continuation(s[lead - 1])) --lead;
+      if(lead == 0) return n;
+      const auto c = static_cast<impl_size_type_helper<sizeof(CharT)>>(s[lead - 1]);
+      std::size_t length = 1;
+      if constexpr(sizeof(CharT) == 1)
+        length = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+      else if constexpr(sizeof(CharT) == 2)
+        length = (c & 0xFC00) == 0xD800 ? 2 : 1;
+      return lead - 1 + length > n ? lead - 1 : n;
+    }
+
+    namespace digits {
+
+      inline constexpr char pairs[] =
+          "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+          "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+          "8081828384858687888990919293949596979899";
+      inline constexpr char alphabet[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+      inline constexpr double powers_of_10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+      // unsigned type used for the arithmetic on the magnitude of a value of 'Int' type
+      template<typename Int>
+      using uint_t =
+          std::conditional_t<(sizeof(Int) <= sizeof(std::uint32_t)), std::uint32_t, std::make_unsigned_t<Int>>;
+
+      template<typename UInt>
+      constexpr std::size_t count(UInt v, unsigned base) noexcept
+      {
+        std::size_t n = 1;
+        if(base == 10) {
+          for(;;) {
+            if(v < 10) return n;
+            if(v < 100) return n + 1;
+            if(v < 1000) return n + 2;
+            if(v < 10000) return n + 3;
+            v /= 10000u;
+            n += 4;
+          }
+        }
+        for(; v >= base; v /= base) ++n;
+        return n;
+      }
+
+      // writes the digits of 'v' backwards ending just before 'last'
+      template<typename CharT, typename UInt>
+      constexpr void write(CharT* last, UInt v, unsigned base) noexcept
+      {
+        if(base == 10) {
+          for(; v >= 100; v /= 100u) {
+            const auto i = static_cast<std::size_t>(v % 100u) * 2;
+            *--last = static_cast<CharT>(pairs[i + 1]);
+            *--last = static_cast<CharT>(pairs[i]);
+          }
+          if(v >= 10) {
+            const auto i = static_cast<std::size_t>(v) * 2;
+            *--last = static_cast<CharT>(pairs[i + 1]);
+            *--last = static_cast<CharT>(pairs[i]);
+          }
+          else
+            *--last = static_cast<CharT>('0' + v);
+          return;
+        }
+        do {
+          *--last = static_cast<CharT>(alphabet[v % base]);
+          v /= base;
+        } while(v);
+      }
+
+      // value of 'c' as a digit in bases up to 36 (36 for other characters)
+      template<typename CharT>
+      constexpr unsigned value(CharT c) noexcept
+      {
+        const auto u = static_cast<impl_size_type_helper<sizeof(CharT)>>(c);
+        if(u >= '0' && u <= '9') return static_cast<unsigned>(u - '0');
+        const auto lower = static_cast<unsigned>(u | 0x20);
+        if(lower >= 'a' && lower <= 'z') return lower - 'a' + 10;
+        return 36;
+      }
+
+      template<typename CharT>
+      constexpr bool is_decimal(CharT c) noexcept
+      {
+        using unit_type = impl_size_type_helper<sizeof(CharT)>;
+        return static_cast<unit_type>(static_cast<unit_type>(c) - '0') < 10;
+      }
+
+      // true if all 8 bytes of a little endian word are decimal digits
+      constexpr bool eight_digits(std::uint64_t v) noexcept
+      {
+        return ((v & 0xF0F0F0F0F0F0F0F0) | (((v + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+               0x3333333333333333;
+      }
+      // value of 8 decimal digits in a little endian word with 3 multiplications (SWAR)
+      constexpr std::uint32_t parse_eight_digits(std::uint64_t v) noexcept
+      {
+        constexpr std::uint64_t mask = 0x000000FF000000FF;
+        constexpr std::uint64_t mul1 = 100 + (1000000ull << 32);
+        constexpr std::uint64_t mul2 = 1 + (10000ull << 32);
+        v -= 0x3030303030303030;
+        v = (v * 10) + (v >> 8);
+        return static_cast<std::uint32_t>((((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32);
+      }
+
+      // Accumulates up to 'limit' decimal digits starting at 'p' into 'v' and returns the end of the consumed ones.
+      // The sequence has to be terminated with a non-digit so no length checks are needed; for 1-byte characters
+      // 8 of them are loaded at a time as long as they are before 'load_end' ('v' has to have 64 bits then).
+      template<typename CharT, typename UInt>
+      inline const CharT* read_decimal(const CharT* p, const CharT* load_end, UInt& v, std::size_t limit) noexcept
+      {
+#if(defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_MSC_VER)
+        if constexpr(sizeof(CharT) == 1) {
+          while(limit >= 8 && load_end - p >= 8) {
+            std::uint64_t w;
+            std::memcpy(&w, p, sizeof(w));
+            if(!eight_digits(w)) break;
+            v = v * 100000000u + parse_eight_digits(w);
+            p += 8;
+            limit -= 8;
+          }
+        }
+#endif
+        for(; limit > 0 && is_decimal(*p); --limit, ++p) v = v * 10u + static_cast<unsigned>(*p - CharT{'0'});
+        return p;
+      }
+
+      // Clinger's fast path: a decimal significand of up to 2^digits and a power of 10 both represented exactly give
+      // a correctly rounded result with one multiplication or division (unless the arithmetic uses excess precision).
+      // Returns the number of the parsed characters or 0 for the text to be handled by std::from_chars().
+      template<typename Float, typename CharT>
+      inline std::size_t parse_float(const CharT* first, const CharT* load_end, Float& result) noexcept
+      {
+        if constexpr(std::numeric_limits<Float>::is_iec559 && FLT_EVAL_METHOD == 0 &&
+                     (std::is_same_v<Float, float> || std::is_same_v<Float, double>)) {
+          constexpr int max_exponent = std::is_same_v<Float, float> ? 10 : 22;
+          constexpr std::uint64_t max_significand = std::uint64_t{1} << std::numeric_limits<Float>::digits;
+
+          auto p = first;
+          const bool negative = *p == CharT{'-'};
+          p += negative;
+          const auto integral = p;
+          while(*p == CharT{'0'}) ++p;
+          std::uint64_t w = 0;
+          auto end = read_decimal(p, load_end, w, 19);
+          std::size_t digits = static_cast<std::size_t>(end - p);
+          bool any = end != integral;
+          p = end;
+          int exponent = 0;
+          if(*p == CharT{'.'}) {
+            const auto fraction = ++p;
+            if(digits == 0)
+              while(*p == CharT{'0'}) ++p;
+            end = read_decimal(p, load_end, w, 19 - digits);
+            digits += static_cast<std::size_t>(end - p);
+            p = end;
+            exponent = -static_cast<int>(p - fraction);
+            any = any || p != fraction;
+          }
+          if(!any || is_decimal(*p)) return 0;  // not a number or more than 19 significant digits
+          if((static_cast<impl_size_type_helper<sizeof(CharT)>>(*p) | 0x20) == 'e') {
+            auto e = p + 1;
+            const bool negative_exponent = *e == CharT{'-'};
+            if(negative_exponent || *e == CharT{'+'}) ++e;
+            unsigned n = 0;
+            end = read_decimal(e, e, n, 3);
+            if(end == e || is_decimal(*end)) return 0;
+            exponent += negative_exponent ? -static_cast<int>(n) : static_cast<int>(n);
+            p = end;
+          }
+          if(w > max_significand || exponent < -max_exponent || exponent > max_exponent) return 0;
+          Float r = static_cast<Float>(w);
+          r = exponent < 0 ? r / static_cast<Float>(powers_of_10[-exponent])
+                           : r * static_cast<Float>(powers_of_10[exponent]);
+          result = negative ? -r : r;
+          return static_cast<std::size_t>(p - first);
+        }
+        else
+          return 0;
+      }
+
+    }  // namespace digits
+
+    namespace hash {
+
+      constexpr std::uint64_t k0 = 0xa0761d6478bd642full;
+      constexpr std::uint64_t k1 = 0xe7037ed1a0b428dbull;
+      constexpr std::uint64_t k2 = 0x8ebc6af09c88c6e3ull;
+      constexpr std::uint64_t k3 = 0x589965cc75374cc3ull;
+
+      // 64x64 -> 128 bit multiplication
+      constexpr void multiply(std::uint64_t& a, std::uint64_t& b) noexcept
+      {
+#if defined(__SIZEOF_INT128__)
+        __extension__ using uint128 = unsigned __int128;
+        const uint128 r = static_cast<uint128>(a) * b;
+        a = static_cast<std::uint64_t>(r);
+        b = static_cast<std::uint64_t>(r >> 64);
+#else
+        const std::uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<std::uint32_t>(a),
+                            lb = static_cast<std::uint32_t>(b);
+        const std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+        std::uint64_t lo = t + (rm1 << 32);
+        std::uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+        a = lo;
+        b = hi;
+#endif
+      }
+
+      constexpr std::uint64_t mix(std::uint64_t a, std::uint64_t b) noexcept
+      {
+        multiply(a, b);
+        return a ^ b;
+      }
+
+      // reads 'Count' bytes of the object representation of 'p' starting at byte 'offset' as a little endian number
+      template<std::size_t Count, typename CharT>
+      constexpr std::uint64_t load(const CharT* p, std::size_t offset) noexcept
+      {
+#if(defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_MSC_VER)
+        if(!is_constant_evaluated()) {
+          std::conditional_t<Count == 8, std::uint64_t, std::uint32_t> v;
+          static_assert(sizeof(v) == Count);
+          std::memcpy(&v, reinterpret_cast<const unsigned char*>(p) + offset, Count);
+          return v;
+        }
+#endif
+        using unsigned_type = std::make_unsigned_t<CharT>;
+        std::uint64_t v = 0;
+        for(std::size_t i = 0; i < Count; ++i) {
+          const std::size_t byte = offset + i;
+          const auto unit = static_cast<unsigned_type>(p[byte / sizeof(CharT)]);
+          v |= static_cast<std::uint64_t>((unit >> (8 * (byte % sizeof(CharT))) & 0xff)) << (8 * i);
+        }
+        return v;
+      }
+
+      template<typename CharT>
+      constexpr std::uint64_t load_byte(const CharT* p, std::size_t offset) noexcept
+      {
+        using unsigned_type = std::make_unsigned_t<CharT>;
+        const auto unit = static_cast<unsigned_type>(p[offset / sizeof(CharT)]);
+        return (unit >> (8 * (offset % sizeof(CharT)))) & 0xff;
+      }
+
+      // Hashes 'n' bytes of the object representation of 'p' (wyhash-style multiply-mix). The result depends only on
+      // the bytes; 'MaxBytes' is an upper bound of 'n' known at compile-time so only the code needed for such
+      // lengths is generated: register-only mixing up to 16 bytes, an unrolled 16-byte loop up to 64 bytes and
+      // 4 independent 16-byte lanes streaming for longer inputs.
+      template<std::size_t MaxBytes, typename CharT>
+      constexpr std::uint64_t bytes(const CharT* p, std::size_t n) noexcept
+      {
+        std::uint64_t seed = k0;
+        std::uint64_t a = 0, b = 0;
+        if(MaxBytes <= 16 || n <= 16) {
+          if(n >= 4) {
+            const std::size_t shift = (n >> 3) << 2;
+            a = (load<4>(p, 0) << 32) | load<4>(p, shift);
+            b = (load<4>(p, n - 4) << 32) | load<4>(p, n - 4 - shift);
+          }
+          else if(n > 0) {
+            a = (load_byte(p, 0) << 16) | (load_byte(p, n >> 1) << 8) | load_byte(p, n - 1);
+          }
+        }
+        else {
+          std::size_t i = n, offset = 0;
+          if constexpr(MaxBytes > 64) {
+            if(i > 64) {
+              std::uint64_t s1 = seed, s2 = seed, s3 = seed;
+              do {
+                seed = mix(load<8>(p, offset) ^ k1, load<8>(p, offset + 8) ^ seed);
+                s1 = mix(load<8>(p, offset + 16) ^ k2, load<8>(p, offset + 24) ^ s1);
+                s2 = mix(load<8>(p, offset + 32) ^ k3, load<8>(p, offset + 40) ^ s2);
+                s3 = mix(load<8>(p, offset + 48) ^ k0, load<8>(p, offset + 56) ^ s3);
+                offset += 64;
+                i -= 64;
+              } while(i > 64);
+              seed ^= s1 ^ s2 ^ s3;
+            }
+          }
+          while(i > 16) {
+            seed = mix(load<8>(p, offset) ^ k1, load<8>(p, offset + 8) ^ seed);
+            offset += 16;
+            i -= 16;
+          }
+          a = load<8>(p, n - 16);
+          b = load<8>(p, n - 8);
+        }
+        a ^= k1;
+        b ^= seed;
+        multiply(a, b);
+        return mix(a ^ k0 ^ n, b ^ k1);
+      }
+
+    }  // namespace hash
+
+    // portable fallback delegating to std::basic_string_view
+    template<typename CharT, typename Traits, typename = void>
+    struct string_kernels {
+      using view = std::basic_string_view<CharT, Traits>;
+
+      static constexpr std::size_t find(const CharT* p, std::size_t n, std::size_t, std::size_t pos, CharT c) noexcept
+      {
+        return view{p, n}.find(c, pos);
+      }
+      static constexpr std::size_t find(const CharT* p, std::size_t n, std::size_t, std::size_t pos, const CharT* s,
+                                        std::size_t m) noexcept
+      {
+        return view{p, n}.find(s, pos, m);
+      }
+      static constexpr std::size_t rfind(const CharT* p, std::size_t n, std::size_t, std::size_t pos, CharT c) noexcept
+      {
+        return view{p, n}.rfind(c, pos);
+      }
+      static constexpr std::size_t rfind(const CharT* p, std::size_t n, std::size_t, std::size_t pos, const CharT* s,
+                                         std::size_t m) noexcept
+      {
+        return view{p, n}.rfind(s, pos, m);
+      }
+      static constexpr std::size_t find_first_of(const CharT* p, std::size_t n, std::size_t, std::size_t pos,
+                                                 const CharT* s, std::size_t m, bool negate) noexcept
+      {
+        return negate ? view{p, n}.find_first_not_of(s, pos, m) : view{p, n}.find_first_of(s, pos, m);
+      }
+      static constexpr std::size_t find_last_of(const CharT* p, std::size_t n, std::size_t, std::size_t pos,
+                                                const CharT* s, std::size_t m, bool negate) noexcept
+      {
+        return negate ? view{p, n}.find_last_not_of(s, pos, m) : view{p, n}.find_last_of(s, pos, m);
+      }
+      static constexpr int compare(const CharT* lhs, std::size_t lhs_size, const CharT* rhs, std::size_t rhs_size,
+                                   std::size_t) noexcept
+      {
+        return view{lhs, lhs_size}.compare(view{rhs, rhs_size});
+      }
+    };
+
+    inline unsigned countr_zero(std::uint32_t x) noexcept
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+      unsigned long idx;
+      _BitScanForward(&idx, x);
+      return static_cast<unsigned>(idx);
+#else
+      return static_cast<unsigned>(__builtin_ctz(x));
+#endif
+    }
+
+    inline unsigned highest_bit(std::uint32_t x) noexcept
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+      unsigned long idx;
+      _BitScanReverse(&idx, x);
+      return static_cast<unsigned>(idx);
+#else
+      return 31u - static_cast<unsigned>(__builtin_clz(x));
+#endif
+    }
+
+    constexpr std::uint32_t low_bits(std::size_t count) noexcept
+    {
+      return count >= 32 ? ~std::uint32_t{} : (std::uint32_t{1} << count) - 1;
+    }
+
+#if defined(MP_INPLACE_STRING_SSE2)
+    namespace simd {
+      // Masks returned by the vector types below have one bit per byte so a character of 'CharSize' bytes is
+      // described by 'CharSize' consecutive bits. Positions and counts given to and returned from the helpers
+      // are always expressed in characters.
+      template<std::size_t CharSize>
+      struct mask_ops {
+        static constexpr std::size_t char_size = CharSize;
+        static std::size_t first(std::uint32_t mask) noexcept { return countr_zero(mask) / CharSize; }
+        static std::size_t last(std::uint32_t mask) noexcept { return highest_bit(mask) / CharSize; }
+        static std::uint32_t low(std::size_t count) noexcept { return low_bits(count * CharSize); }
+        static std::uint32_t shift(std::uint32_t mask, std::size_t count) noexcept
+        {
+          return mask >> (count * CharSize);
+        }
+      };
+
+      template<std::size_t CharSize = 1>
+      struct sse2 : mask_ops<CharSize> {
+        using reg = __m128i;
+        static constexpr std::size_t width = 16 / CharSize;
+        static reg load(const void* p) noexcept { return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+        template<typename CharT>
+        static reg broadcast(CharT c) noexcept
+        {
+          if constexpr(CharSize == 1)
+            return _mm_set1_epi8(static_cast<char>(c));
+          else if constexpr(CharSize == 2)
+            return _mm_set1_epi16(static_cast<short>(c));
+          else
+            return _mm_set1_epi32(static_cast<int>(c));
+        }
+        static std::uint32_t eq(reg a, reg b) noexcept
+        {
+          if constexpr(CharSize == 1)
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+          else if constexpr(CharSize == 2)
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(a, b)));
+          else
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi32(a, b)));
+        }
+      };
+
+#if defined(MP_INPLACE_STRING_AVX2)
+      template<std::size_t CharSize = 1>
+      struct avx2 : mask_ops<CharSize> {
+        using reg = __m256i;
+        static constexpr std::size_t width = 32 / CharSize;
+        static reg load(const void* p) noexcept { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+        template<typename CharT>
+        static reg broadcast(CharT c) noexcept
+        {
+          if constexpr(CharSize == 1)
+            return _mm256_set1_epi8(static_cast<char>(c));
+          else if constexpr(CharSize == 2)
+            return _mm256_set1_epi16(static_cast<short>(c));
+          else
+            return _mm256_set1_epi32(static_cast<int>(c));
+        }
+        static std::uint32_t eq(reg a, reg b) noexcept
+        {
+          if constexpr(CharSize == 1)
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+          else if constexpr(CharSize == 2)
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(a, b)));
+          else
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi32(a, b)));
+        }
+      };
+#endif
+
+      // All kernels below get 'readable' - the number of characters that can be safely loaded starting from 'p'
+      // (that is the whole in-place buffer and not only its 'n' characters in use). It must be at least V::width.
+      // Loads that would run past it are moved back to end exactly at 'readable' and the resulting mask is
+      // shifted, so the character 'i' of the returned mask always describes the character at 'q + i'.
+      template<typename V, typename CharT>
+      inline std::uint32_t match(const CharT* p, std::size_t q, std::size_t readable, typename V::reg v) noexcept
+      {
+        const std::size_t b = q + V::width <= readable ? q : readable - V::width;
+        return V::shift(V::eq(V::load(p + b), v), q - b);
+      }
+
+      template<typename V, typename CharT>
+      std::size_t find(const CharT* p, std::size_t n, std::size_t readable, std::size_t pos, CharT c) noexcept
+      {
+        if(pos >= n) return std::basic_string_view<CharT>::npos;  // also keeps 'i + V::width' from wrapping around
+        const auto v = V::broadcast(c);
+        std::size_t i = pos;
+        for(; i + V::width <= n; i += V::width)
+          if(const auto mask = V::eq(V::load(p + i), v)) return i + V::first(mask);
+        if(i < n) {
+          const auto mask = match<V>(p, i, readable, v) & V::low(n - i);
+          if(mask) return i + V::first(mask);
+        }
+        return std::basic_string_view<CharT>::npos;
+      }
+
+      template<typename V, typename CharT>
+      std::size_t rfind(const CharT* p, std::size_t n, std::size_t readable, std::size_t pos, CharT c) noexcept
+      {
+        const auto v = V::broadcast(c);
+        for(std::size_t e = n ? std::min(pos, n - 1) + 1 : 0; e > 0;) {
+          const std::size_t s = e > V::width ? e - V::width : 0;
+          const auto mask = match<V>(p, s, readable, v) & V::low(e - s);
+          if(mask) return s + V::last(mask);
+          e = s;
+        }
+        return std::basic_string_view<CharT>::npos;
+      }
+
+      // candidates are filtered by matching both the first and the last character of the needle
+      template<typename V, typename Traits, typename CharT>
+      std::size_t find(const CharT* p, std::size_t n, std::size_t readable, std::size_t pos, const CharT* s,
+                       std::size_t m) noexcept
+      {
+        if(pos > n || m > n - pos) return std::basic_string_view<CharT>::npos;
+        if(m == 0) return pos;
+        if(m == 1) return find<V>(p, n, readable, pos, s[0]);
+        const auto first = V::broadcast(s[0]);
+        const auto last = V::broadcast(s[m - 1]);
+        const std::size_t end = n - m + 1;
+        for(std::size_t i = pos; i < end; i += V::width) {
+          auto mask = match<V>(p, i, readable, first) & match<V>(p, i + m - 1, readable, last) & V::low(end - i);
+          while(mask) {
+            const auto j = V::first(mask);
+            if(Traits::compare(p + i + j + 1, s + 1, m - 2) == 0) return i + j;
+            mask &= ~V::low(j + 1);
+          }
+        }
+        return std::basic_string_view<CharT>::npos;
+      }
+
+      template<typename V, typename Traits, typename CharT>
+      std::size_t rfind(const CharT* p, std::size_t n, std::size_t readable, std::size_t pos, const CharT* s,
+                        std::size_t m) noexcept
+      {
+        if(m > n) return std::basic_string_view<CharT>::npos;
+        if(m == 0) return std::min(pos, n);
+        if(m == 1) return rfind<V>(p, n, readable, pos, s[0]);
+        const auto first = V::broadcast(s[0]);
+        const auto last = V::broadcast(s[m - 1]);
+        for(std::size_t e = std::min(pos, n - m) + 1; e > 0;) {
+          const std::size_t b = e > V::width ? e - V::width : 0;
+          auto mask = match<V>(p, b, readable, first) & match<V>(p, b + m - 1, readable, last) & V::low(e - b);
+          while(mask) {
+            const auto j = V::last(mask);
+            if(Traits::compare(p + b + j + 1, s + 1, m - 2) == 0) return b + j;
+            mask &= V::low(j);
+          }
+          e = b;
+        }
+        return std::basic_string_view<CharT>::npos;
+      }
+
+      // both buffers have to provide 'readable' characters
+      template<typename V, typename Traits, typename CharT>
+      int compare(const CharT* lhs, std::size_t lhs_size, const CharT* rhs, std::size_t rhs_size,
+                  std::size_t readable) noexcept
+      {
+        const std::size_t n = std::min(lhs_size, rhs_size);
+        std::size_t i = 0;
+        for(; i + V::width <= n; i += V::width) {
+          const auto mask = ~V::eq(V::load(lhs + i), V::load(rhs + i)) & V::low(V::width);
+          if(mask) {
+            const auto j = i + V::first(mask);
+            return Traits::lt(lhs[j], rhs[j]) ? -1 : 1;
+          }
+        }
+        if(i < n) {
+          const std::size_t b = i + V::width <= readable ? i : readable - V::width;
+          const auto equal = V::shift(V::eq(V::load(lhs + b), V::load(rhs + b)), i - b);
+          const auto mask = ~equal & V::low(n - i);
+          if(mask) {
+            const auto j = i + V::first(mask);
+            return Traits::lt(lhs[j], rhs[j]) ? -1 : 1;
+          }
+        }
+        return lhs_size < rhs_size ? -1 : (lhs_size > rhs_size ? 1 : 0);
+      }
+
+      // bigger character sets are handled with a lookup table by the caller
+      constexpr std::size_t max_simd_set_size = 16;
+
+      template<typename V, typename CharT>
+      inline std::uint32_t match_any(const CharT* p, std::size_t q, std::size_t readable, const typename V::reg* set,
+                                     std::size_t m) noexcept
+      {
+        const std::size_t b = q + V::width <= readable ? q : readable - V::width;
+        const auto chars = V::load(p + b);
+        std::uint32_t mask = 0;
+        for(std::size_t i = 0; i < m; ++i) mask |= V::eq(chars, set[i]);
+        return V::shift(mask, q - b);
+      }
+
+      template<typename V, typename CharT>
+      std::size_t find_first_of(const CharT* p, std::size_t n, std::size_t readable, std::size_t pos, const CharT* s,
+                                std::size_t m, bool negate) noexcept
+      {
+        if(pos >= n) return std::basic_string_view<CharT>::npos;
+        typename V::reg set[max_simd_set_size];
+        for(std::size_t i = 0; i < m; ++i) set[i] = V::broadcast(s[i]);
+        for(std::size_t i = pos; i < n; i += V::width) {
+          auto mask = match_any<V>(p, i, readable, set, m);
+          if(negate) mask = ~mask;
+          mask &= V::low(std::min(n - i, V::width));
+          if(mask) return i + V::first(mask);
+        }
+        return std::basic_string_view<CharT>::npos;
+      }
+
+      template<typename V, typename CharT>
+      std::size_t find_last_of(const CharT* p, std::size_t n, std::size_t readable, std::size_t pos, const CharT* s,
+                               std::size_t m, bool negate) noexcept
+      {
+        typename V::reg set[max_simd_set_size];
+        for(std::size_t i = 0; i < m; ++i) set[i] = V::broadcast(s[i]);
+        for(std::size_t e = n ? std::min(pos, n - 1) + 1 : 0; e > 0;) {
+          const std::size_t b = e > V::width ? e - V::width : 0;
+          auto mask = match_any<V>(p, b, readable, set, m);
+          if(negate) mask = ~mask;
+          mask &= V::low(e - b);
+          if(mask) return b + V::last(mask);
+          e = b;
+        }
+        return std::basic_string_view<CharT>::npos;
+      }
+
+      template<typename CharT>
+      struct char_set {
+        bool contains[256] = {};
+        char_set(const CharT* s, std::size_t m) noexcept
+        {
+          for(std::size_t i = 0; i < m; ++i) contains[static_cast<unsigned char>(s[i])] = true;
+        }
+        bool operator()(CharT c) const noexcept { return contains[static_cast<unsigned char>(c)]; }
+      };
+    }  // namespace simd
+
+    // compares two buffers of compile-time size with (possibly overlapping) full-width vector loads
+    template<std::size_t Bytes>
+    inline bool equal_buffers(const void* lhs, const void* rhs) noexcept
+    {
+      if constexpr(Bytes < simd::sse2<>::width) {
+        return std::memcmp(lhs, rhs, Bytes) == 0;
+      }
+      else {
+#if defined(MP_INPLACE_STRING_AVX2)
+        using V = std::conditional_t<(Bytes >= simd::avx2<>::width), simd::avx2<>, simd::sse2<>>;
+#else
+        using V = simd::sse2<>;
+#endif
+        const auto a = static_cast<const unsigned char*>(lhs);
+        const auto b = static_cast<const unsigned char*>(rhs);
+        std::uint32_t mask = low_bits(V::width);
+        for(std::size_t i = 0; i < Bytes; i += V::width) {
+          const std::size_t offset = i + V::width <= Bytes ? i : Bytes - V::width;
+          mask &= V::eq(V::load(a + offset), V::load(b + offset));
+        }
+        return mask == low_bits(V::width);
+      }
+    }
+
+    // SSE2/AVX2 kernels for 1, 2 and 4-byte characters with the standard character traits
+    template<typename CharT, typename Traits>
+    struct string_kernels<CharT, Traits,
+                          std::enable_if_t<(sizeof(CharT) == 1 || sizeof(CharT) == 2 || sizeof(CharT) == 4) &&
+                                           std::is_same<Traits, std::char_traits<CharT>>::value>> {
+      using fallback = string_kernels<CharT, Traits, bool>;  // never matches a specialization
+      using sse2 = simd::sse2<sizeof(CharT)>;
+#if defined(MP_INPLACE_STRING_AVX2)
+      using avx2 = simd::avx2<sizeof(CharT)>;
+#endif
+      static constexpr std::size_t npos = std::basic_string_view<CharT, Traits>::npos;
+
+      // memchr() and memcmp() of the C library unroll wider than the kernels below so they win for long inputs
+      // (character traits of wider characters are often plain loops so those are never delegated to)
+      static constexpr std::size_t libc_threshold = sizeof(CharT) == 1 ? 128 : npos;
+
+      static std::size_t find(const CharT* p, std::size_t n, std::size_t readable, std::size_t pos, CharT c) noexcept
+      {
+        if(pos >= n) return npos;
+        if(n - pos > libc_threshold) return fallback::find(p, n, readable, pos, c);
+#if defined(MP_INPLACE_STRING_AVX2)
+        if(readable >= avx2::width && n - pos > sse2::width)
+          return simd::find<avx2>(p, n, readable, pos, c);
+#endif
+        if(readable >= sse2::width) return simd::find<sse2>(p, n, readable, pos, c);
+        return fallback::find(p, n, readable, pos, c);
+      }
+      static std::size_t find(const CharT* p, std::size_t n, std::size_t readable, std::size_t pos, const CharT* s,
+                              std::size_t m) noexcept
+      {
+        if(pos > n || m > n - pos) return npos;
+#if defined(MP_INPLACE_STRING_AVX2)
+        if(readable >= avx2::width && n - pos > sse2::width)
+          return simd::find<avx2, Traits>(p, n, readable, pos, s, m);
+#endif
+        if(readable >= sse2::width) return simd::find<sse2, Traits>(p, n, readable, pos, s, m);
+        return fallback::find(p, n, readable, pos, s, m);
+      }
+      static std::size_t rfind(const CharT* p, std::size_t n, std::size_t readable, std::size_t pos, CharT c) noexcept
+      {
+#if defined(MP_INPLACE_STRING_AVX2)
+        if(readable >= avx2::width && std::min(pos, n) > sse2::width)
+          return simd::rfind<avx2>(p, n, readable, pos, c);
+#endif
+        if(readable >= sse2::width) return simd::rfind<sse2>(p, n, readable, pos, c);
+        return fallback::rfind(p, n, readable, pos, c);
+      }
+      static std::size_t rfind(const CharT* p, std::size_t n, std::size_t readable, std::size_t pos, const CharT* s,
+                               std::size_t m) noexcept
+      {
+#if defined(MP_INPLACE_STRING_AVX2)
+        if(readable >= avx2::width && std::min(pos, n) > sse2::width)
+          return simd::rfind<avx2, Traits>(p, n, readable, pos, s, m);
+#endif
+        if(readable >= sse2::width) return simd::rfind<sse2, Traits>(p, n, readable, pos, s, m);
+        return fallback::rfind(p, n, readable, pos, s, m);
+      }
+      static std::size_t find_first_of(const CharT* p, std::size_t n, std::size_t readable, std::size_t pos,
+                                       const CharT* s, std::size_t m, bool negate) noexcept
+      {
+        if(pos >= n) return npos;
+        if(m > simd::max_simd_set_size) {
+          if constexpr(sizeof(CharT) == 1) {
+            const simd::char_set<CharT> set{s, m};
+            for(std::size_t i = pos; i < n; ++i)
+              if(set(p[i]) != negate) return i;
+            return npos;
+          }
+          else
+            return fallback::find_first_of(p, n, readable, pos, s, m, negate);
+        }
+#if defined(MP_INPLACE_STRING_AVX2)
+        if(readable >= avx2::width && n - pos > sse2::width)
+          return simd::find_first_of<avx2>(p, n, readable, pos, s, m, negate);
+#endif
+        if(readable >= sse2::width) return simd::find_first_of<sse2>(p, n, readable, pos, s, m, negate);
+        return fallback::find_first_of(p, n, readable, pos, s, m, negate);
+      }
+      static std::size_t find_last_of(const CharT* p, std::size_t n, std::size_t readable, std::size_t pos,
+                                      const CharT* s, std::size_t m, bool negate) noexcept
+      {
+        if(m > simd::max_simd_set_size) {
+          if constexpr(sizeof(CharT) == 1) {
+            const simd::char_set<CharT> set{s, m};
+            for(std::size_t i = n ? std::min(pos, n - 1) + 1 : 0; i > 0; --i)
+              if(set(p[i - 1]) != negate) return i - 1;
+            return npos;
+          }
+          else
+            return fallback::find_last_of(p, n, readable, pos, s, m, negate);
+        }
+#if defined(MP_INPLACE_STRING_AVX2)
+        if(readable >= avx2::width && std::min(pos, n) > sse2::width)
+          return simd::find_last_of<avx2>(p, n, readable, pos, s, m, negate);
+#endif
+        if(readable >= sse2::width) return simd::find_last_of<sse2>(p, n, readable, pos, s, m, negate);
+        return fallback::find_last_of(p, n, readable, pos, s, m, negate);
+      }
+      static int compare(const CharT* lhs, std::size_t lhs_size, const CharT* rhs, std::size_t rhs_size,
+                         std::size_t readable) noexcept
+      {
+        if(std::min(lhs_size, rhs_size) > libc_threshold)
+          return fallback::compare(lhs, lhs_size, rhs, rhs_size, readable);
+#if defined(MP_INPLACE_STRING_AVX2)
+        if(readable >= avx2::width && std::min(lhs_size, rhs_size) > sse2::width)
+          return simd::compare<avx2, Traits>(lhs, lhs_size, rhs, rhs_size, readable);
+#endif
+        if(readable >= sse2::width) return simd::compare<sse2, Traits>(lhs, lhs_size, rhs, rhs_size, readable);
+        return fallback::compare(lhs, lhs_size, rhs, rhs_size, readable);
+      }
+    };
+#else
+    template<std::size_t Bytes>
+    inline bool equal_buffers(const void* lhs, const void* rhs) noexcept
+    {
+      return std::memcmp(lhs, rhs, Bytes) == 0;
+    }
+#endif  // MP_INPLACE_STRING_SSE2
   }
 
-  template<typename CharT, std::size_t MaxSize, typename Traits = std::char_traits<std::decay_t<CharT>>>
-  class basic_inplace_string {
-    using impl_size_type = ::mp::detail::impl_size_type_helper<sizeof(CharT)>;
-    static_assert(MaxSize <= std::numeric_limits<impl_size_type>::max(),
-                  "impl_size_type type too small to store MaxSize characters");
+  enum class inplace_string_overflow {
+    throw_exception,  // std::length_error is thrown and the string is left unchanged
+    truncate,         // characters that do not fit are dropped
+    truncate_utf8,    // as 'truncate' but a UTF-8 (UTF-16 for 2-byte characters) code point is never split
+    unchecked         // only asserted; overflow is undefined behavior
+  };
+
+  enum class inplace_string_size_placement {
+    back,  // after the characters as max_size() - size() so it is the terminator of a full string
+    front  // before the characters so size() shares a cache line with the beginning of the text
+  };
+
+  enum class inplace_string_copy {
+    full,    // the whole storage; the string is trivially copyable
+    bounded  // only the characters in use, the terminator and the size (in fixed-size blocks)
+  };
+
+  // Result of the non-throwing try_* modifiers: the number of characters written and std::errc::value_too_large
+  // if not all of the requested ones did fit (std::errc::invalid_argument for an out of range position).
+  struct inplace_string_result {
+    std::size_t count;
+    std::errc ec;
+
+    constexpr explicit operator bool() const noexcept { return ec == std::errc{}; }
+  };
+
+  // Result of basic_inplace_string::parse<T>(): the value and std::errc::invalid_argument if the string is not
+  // exactly a number (std::errc::result_out_of_range if it does not fit in 'T')
+  template<typename T>
+  struct inplace_string_parse_result {
+    T value;
+    std::errc ec;
+
+    constexpr explicit operator bool() const noexcept { return ec == std::errc{}; }
+  };
+
+  // Tag selecting the constructor that leaves the characters and the size indeterminate (no write pass over
+  // the storage). Such a string may only be assigned to or destroyed.
+  struct uninitialized_t {
+    explicit uninitialized_t() = default;
+  };
+  inline constexpr uninitialized_t uninitialized{};
+
+  // Compile-time customization of basic_inplace_string layout and behavior. To change only some of the
+  // settings derive from default_inplace_string_policy and redefine the selected members.
+  struct default_inplace_string_policy {
+    // When true every mutating member keeps the characters past size() zeroed so two strings of the same
+    // type are equal if and only if their whole buffers are equal. That allows fixed-width comparisons
+    // at the cost of clearing the released characters each time the string shrinks.
+    static constexpr bool zero_padded_tail = false;
+
+    // What happens when a mutating member would exceed max_size(). Only 'throw_exception' makes the mutating
+    // members potentially throwing.
+    static constexpr inplace_string_overflow overflow = inplace_string_overflow::throw_exception;
+
+    // Where the size is stored. Its width is selected from MaxSize and it takes as many characters as needed
+    // (i.e. 2 characters of 'char' for MaxSize up to 65535).
+    static constexpr inplace_string_size_placement size_placement = inplace_string_size_placement::back;
+
+    // Alignment of the object (values below alignof(CharT) are ignored). The storage is rounded up to its
+    // multiple and the vector kernels may read the whole of it, so with alignment not smaller than the vector
+    // width they only ever do full-width loads that never cross a cache line.
+    static constexpr std::size_t alignment = 1;
+
+    // How copy construction, copy assignment and swap() transfer the contents. 'bounded' makes them read and write
+    // only the blocks holding size() characters (plus the trailing size in back placement) which saves memory
+    // bandwidth when MaxSize is in hundreds or more and strings are mostly less than half full. The string is no
+    // longer trivially copyable then (it stays trivially relocatable). Storage of up to 64 bytes is always copied
+    // whole. Cannot be used with 'zero_padded_tail'.
+    static constexpr inplace_string_copy copy = inplace_string_copy::full;
+  };
+
+  struct zero_padded_inplace_string_policy : default_inplace_string_policy {
+    static constexpr bool zero_padded_tail = true;
+  };
+
+  template<std::size_t Alignment>
+  struct aligned_inplace_string_policy : default_inplace_string_policy {
+    static constexpr std::size_t alignment = Alignment;
+  };
+
+  // size in front so that the used part of the storage is one contiguous prefix
+  struct bounded_copy_inplace_string_policy : default_inplace_string_policy {
+    static constexpr inplace_string_size_placement size_placement = inplace_string_size_placement::front;
+    static constexpr inplace_string_copy copy = inplace_string_copy::bounded;
+  };
+
+  namespace detail {
+
+    // Storage layout of basic_inplace_string (all positions in characters).
+    // Back placement: characters followed by max_size() - size() stored on 'size_units' trailing characters
+    // (all of them are zero for a full string so they work as its terminator).
+    // Front placement: size() stored on 'size_units' leading characters followed by the characters and
+    // the terminator.
+    // Any padding up to the alignment comes last.
+    template<typename CharT, std::size_t MaxSize, typename Policy>
+    struct inplace_string_layout {
+      using unit_type = impl_size_type_helper<sizeof(CharT)>;  // character as an unsigned number
+      using size_type = uint_least_t<MaxSize>;
+
+      static constexpr bool size_in_front = Policy::size_placement == inplace_string_size_placement::front;
+      static constexpr std::size_t size_units = (sizeof(size_type) + sizeof(CharT) - 1) / sizeof(CharT);
+      static constexpr std::size_t unit_bits = std::numeric_limits<unit_type>::digits;
+      static constexpr std::size_t size_offset = size_in_front ? 0 : MaxSize;
+      static constexpr std::size_t data_offset = size_in_front ? size_units : 0;
+      static constexpr std::size_t alignment = std::max(Policy::alignment, alignof(CharT));
+      static_assert((alignment & (alignment - 1)) == 0, "alignment has to be a power of 2");
+      static constexpr std::size_t storage_units = [] {
+        constexpr std::size_t units = MaxSize + size_units + (size_in_front ? 1 : 0);
+        constexpr std::size_t multiple = std::max<std::size_t>(alignment / sizeof(CharT), 1);
+        return (units + multiple - 1) / multiple * multiple;
+      }();
+
+      static constexpr size_type load_size(const CharT* chars) noexcept
+      {
+        size_type v = 0;
+        for(std::size_t i = 0; i < size_units; ++i) {
+          const auto unit = static_cast<unit_type>(chars[size_offset + i]);
+          v |= static_cast<size_type>(static_cast<size_type>(unit) << (i * unit_bits));
+        }
+        return v;
+      }
+      static constexpr void store_size(CharT* chars, size_type v) noexcept
+      {
+        for(std::size_t i = 0; i < size_units; ++i)
+          chars[size_offset + i] = static_cast<CharT>(static_cast<unit_type>(v >> (i * unit_bits)));
+      }
+    };
+
+    template<typename CharT, std::size_t MaxSize, typename Policy,
+             bool Bounded = Policy::copy == inplace_string_copy::bounded>
+    struct inplace_string_storage {
+      using layout = inplace_string_layout<CharT, MaxSize, Policy>;
+      alignas(layout::alignment) std::array<CharT, layout::storage_units> chars_;
+    };
+
+    template<typename CharT, std::size_t MaxSize, typename Policy>
+    struct inplace_string_storage<CharT, MaxSize, Policy, true> {
+      using layout = inplace_string_layout<CharT, MaxSize, Policy>;
+      static_assert(!Policy::zero_padded_tail, "bounded copies would leave the tail of the copy not zeroed");
+      alignas(layout::alignment) std::array<CharT, layout::storage_units> chars_;
+
+      inplace_string_storage() = default;
+      inplace_string_storage(const inplace_string_storage& other) noexcept { copy(other); }
+      inplace_string_storage& operator=(const inplace_string_storage& other) noexcept
+      {
+        if(this != &other) copy(other);
+        return *this;
+      }
+
+    private:
+      // short texts are copied with a few fixed-size block moves as a call to a variable length memcpy() costs
+      // more than copying a few hundred bytes
+      void copy(const inplace_string_storage& other) noexcept
+      {
+        constexpr std::size_t block = 32;
+        constexpr std::size_t bytes = sizeof(chars_);
+        const auto dst = reinterpret_cast<unsigned char*>(chars_.data());
+        const auto src = reinterpret_cast<const unsigned char*>(other.chars_.data());
+        if constexpr(bytes <= 2 * block) {
+          std::memcpy(dst, src, bytes);
+        }
+        else {
+          const std::size_t stored = layout::load_size(other.chars_.data());
+          const std::size_t size = layout::size_in_front ? stored : MaxSize - stored;
+          const std::size_t used = (layout::data_offset + size + 1) * sizeof(CharT);
+          if(used <= 8 * block) {
+            for(std::size_t offset = 0; offset < used; offset += block) {
+              const auto o = std::min(offset, bytes - block);
+              std::memcpy(dst + o, src + o, block);
+            }
+          }
+          else
+            std::memcpy(dst, src, std::min((used + block - 1) / block * block, bytes));
+          if constexpr(!layout::size_in_front) std::memcpy(dst + bytes - block, src + bytes - block, block);
+        }
+      }
+    };
+
+  }  // namespace detail
+
+  template<typename CharT, std::size_t MaxSize, typename Traits = std::char_traits<std::decay_t<CharT>>,
+           typename Policy = default_inplace_string_policy>
+  class basic_inplace_string : private detail::inplace_string_storage<CharT, MaxSize, Policy> {
+    using storage_base = detail::inplace_string_storage<CharT, MaxSize, Policy>;
+    using layout = typename storage_base::layout;
+    using impl_size_type = typename layout::size_type;
 
   public:
     using traits_type = Traits;
@@ -69,15 +1120,21 @@ namespace mp {
     static constexpr size_type npos = static_cast<size_type>(-1);
 
     // constructors
-    constexpr basic_inplace_string() noexcept { clear(); }
+    constexpr basic_inplace_string() noexcept
+    {
+      init();
+      clear();
+    }
+    // zero padded strings are still fully initialized as other members rely on the zeroed tail
+    explicit basic_inplace_string(uninitialized_t) noexcept { init(); }
     basic_inplace_string(const basic_inplace_string&) = default;
-    template<std::size_t OtherMaxSize>
-    constexpr basic_inplace_string(const basic_inplace_string<CharT, OtherMaxSize, Traits>& str, size_type pos)
+    template<std::size_t OtherMaxSize, typename OtherPolicy>
+    constexpr basic_inplace_string(const basic_inplace_string<CharT, OtherMaxSize, Traits, OtherPolicy>& str, size_type pos)
         : basic_inplace_string{std::basic_string_view<CharT, Traits>{str}.substr(pos)}
     {
     }
-    template<std::size_t OtherMaxSize>
-    constexpr basic_inplace_string(const basic_inplace_string<CharT, OtherMaxSize, Traits>& str, size_type pos,
+    template<std::size_t OtherMaxSize, typename OtherPolicy>
+    constexpr basic_inplace_string(const basic_inplace_string<CharT, OtherMaxSize, Traits, OtherPolicy>& str, size_type pos,
                                    size_type n)
         : basic_inplace_string{std::basic_string_view<CharT, Traits>{str}.substr(pos, n)}
     {
@@ -93,15 +1150,42 @@ namespace mp {
         : basic_inplace_string{sv.data(), sv.size()}
     {
     }
-    constexpr basic_inplace_string(const_pointer s, size_type count) noexcept { assign(s, count); }
-    constexpr basic_inplace_string(const_pointer s) noexcept : basic_inplace_string{s, traits_type::length(s)} {}
-    constexpr basic_inplace_string(size_type n, value_type c) { assign(n, c); }
+    constexpr basic_inplace_string(const_pointer s, size_type count) noexcept(nothrow_overflow)
+    {
+      init();
+      assign(s, count);
+    }
+    template<typename Ptr, detail::Requires<std::is_convertible<Ptr, const_pointer>> = true>
+    constexpr basic_inplace_string(Ptr s) noexcept(nothrow_overflow) : basic_inplace_string{s, traits_type::length(s)}
+    {
+    }
+    template<std::size_t N>
+    constexpr basic_inplace_string(const CharT (&s)[N]) noexcept(nothrow_overflow)
+    {
+      init();
+      assign(s);
+    }
+    template<std::size_t N>
+    constexpr basic_inplace_string(CharT (&s)[N]) noexcept(nothrow_overflow)
+        : basic_inplace_string{static_cast<const_pointer>(s)}
+    {
+    }
+    constexpr basic_inplace_string(size_type n, value_type c) noexcept(nothrow_overflow)
+    {
+      init();
+      assign(n, c);
+    }
     template<class InputIterator>
     constexpr basic_inplace_string(InputIterator begin, InputIterator end)
     {
+      init();
       assign(begin, end);
     }
-    constexpr basic_inplace_string(std::initializer_list<CharT> ilist) { assign(ilist.begin(), ilist.size()); }
+    constexpr basic_inplace_string(std::initializer_list<CharT> ilist)
+    {
+      init();
+      assign(ilist.begin(), ilist.size());
+    }
 
     // assignment
     basic_inplace_string& operator=(const basic_inplace_string&) = default;
@@ -109,7 +1193,21 @@ namespace mp {
     {
       return assign(sv);
     }
-    constexpr basic_inplace_string& operator=(const_pointer s) noexcept { return assign(s); }
+    template<typename Ptr, detail::Requires<std::is_convertible<Ptr, const_pointer>> = true>
+    constexpr basic_inplace_string& operator=(Ptr s) noexcept(nothrow_overflow)
+    {
+      return assign(s);
+    }
+    template<std::size_t N>
+    constexpr basic_inplace_string& operator=(const CharT (&s)[N]) noexcept(nothrow_overflow)
+    {
+      return assign(s);
+    }
+    template<std::size_t N>
+    constexpr basic_inplace_string& operator=(CharT (&s)[N]) noexcept(nothrow_overflow)
+    {
+      return assign(static_cast<const_pointer>(s));
+    }
     constexpr basic_inplace_string& operator=(value_type c) noexcept { return assign(1, c); }
     constexpr basic_inplace_string& operator=(std::initializer_list<CharT> ilist)
     {
@@ -142,17 +1240,27 @@ namespace mp {
     constexpr const_reverse_iterator crend() const { return const_reverse_iterator{cbegin()}; }
 
     // capacity
-    constexpr size_type size() const { return max_size() - static_cast<impl_size_type>(chars_.back()); }
+    constexpr size_type size() const
+    {
+      if constexpr(size_in_front)
+        return stored_size();
+      else
+        return max_size() - stored_size();
+    }
     constexpr size_type length() const { return size(); }
     constexpr size_type max_size() const { return MaxSize; }
-    constexpr void resize(size_type n, value_type c)
+    constexpr void resize(size_type n, value_type c) noexcept(nothrow_overflow)
     {
       const auto sz = size();
-      size(n);
-      if(n > sz)
+      if(n > sz) {
+        n = sz + fit(sz, n - sz);
+        size(n);
         traits_type::assign(data() + sz, n - sz, c);
+      }
+      else
+        size(n);
     }
-    constexpr void resize(size_type n) { resize(n, value_type{}); }
+    constexpr void resize(size_type n) noexcept(nothrow_overflow) { resize(n, value_type{}); }
     constexpr void clear() { size(0); }
     constexpr bool empty() const { return size() == 0; }
 
@@ -175,8 +1283,8 @@ namespace mp {
     constexpr const_reference back() const { return (*this)[size() - 1]; }
 
     // modifiers
-    template<std::size_t OtherMaxSize>
-    basic_inplace_string& operator+=(const basic_inplace_string<CharT, OtherMaxSize, Traits>& str)
+    template<std::size_t OtherMaxSize, typename OtherPolicy>
+    basic_inplace_string& operator+=(const basic_inplace_string<CharT, OtherMaxSize, Traits, OtherPolicy>& str)
     {
       return append(str);
     }
@@ -189,10 +1297,10 @@ namespace mp {
     }
     basic_inplace_string& operator+=(std::initializer_list<CharT> il) { return append(il); }
 
-    template<std::size_t OtherMaxSize>
-    basic_inplace_string& append(const basic_inplace_string<CharT, OtherMaxSize, Traits>& str) { return append(str.data(), str.size()); }
-    template<std::size_t OtherMaxSize>
-    basic_inplace_string& append(const basic_inplace_string<CharT, OtherMaxSize, Traits>& str, size_type pos,
+    template<std::size_t OtherMaxSize, typename OtherPolicy>
+    basic_inplace_string& append(const basic_inplace_string<CharT, OtherMaxSize, Traits, OtherPolicy>& str) { return append(str.data(), str.size()); }
+    template<std::size_t OtherMaxSize, typename OtherPolicy>
+    basic_inplace_string& append(const basic_inplace_string<CharT, OtherMaxSize, Traits, OtherPolicy>& str, size_type pos,
                                  size_type n = npos)
     {
       return append(std::basic_string_view<CharT, Traits>{str}.substr(pos, n));
@@ -204,34 +1312,66 @@ namespace mp {
     basic_inplace_string& append(const T& t, size_type pos, size_type n = npos) {
       return append(std::basic_string_view<CharT, Traits>{t}.substr(pos, n));
     }
-    basic_inplace_string& append(const_pointer s, size_type n)
+    basic_inplace_string& append(const_pointer s, size_type n) noexcept(nothrow_overflow)
     {
       const auto sz = size();
+      n = fit(sz, n, s);
       size(sz + n);
       traits_type::copy(data() + sz, s, n);
       return *this;
     }
-    basic_inplace_string& append(const_pointer s) { return append(s, traits_type::length(s)); }
-    basic_inplace_string& append(size_type n, value_type c) { resize(size() + n, c); return *this; }
+    basic_inplace_string& append(const_pointer s) noexcept(nothrow_overflow)
+    {
+      return append(s, traits_type::length(s));
+    }
+    basic_inplace_string& append(size_type n, value_type c) noexcept(nothrow_overflow)
+    {
+      const auto sz = size();
+      n = fit(sz, n);
+      size(sz + n);
+      traits_type::assign(data() + sz, n, c);
+      return *this;
+    }
     template<class InputIterator>
     basic_inplace_string& append(InputIterator first, InputIterator last)
     {
       const auto sz = size();
-      const auto count = std::distance(first, last);
+      const auto count = fit(sz, static_cast<size_type>(std::distance(first, last)), first);
       size(sz + count);
-      traits_type::copy(data() + sz, first, count);
+      std::copy_n(first, count, data() + sz);
       return *this;
     }
     basic_inplace_string& append(std::initializer_list<CharT> il) { return append(il.begin(), il.end()); }
-    void push_back(value_type c) { append(static_cast<size_type>(1), c); }
+    void push_back(value_type c) noexcept(nothrow_overflow) { append(static_cast<size_type>(1), c); }
+
+    basic_inplace_string& insert(size_type index, size_type count, value_type c)
+    {
+      if(index > size()) throw std::out_of_range("inplace_string::insert: 'index' out of range");
+      insert_chars(index, fit(size(), count), c);
+      return *this;
+    }
+    basic_inplace_string& insert(size_type index, std::basic_string_view<CharT, Traits> sv)
+    {
+      if(index > size()) throw std::out_of_range("inplace_string::insert: 'index' out of range");
+      insert_chars(index, sv.data(), fit(size(), sv.size(), sv.data()));
+      return *this;
+    }
+    basic_inplace_string& insert(size_type index, const_pointer s, size_type count)
+    {
+      return insert(index, std::basic_string_view<CharT, Traits>{s, count});
+    }
+    basic_inplace_string& insert(size_type index, const_pointer s)
+    {
+      return insert(index, std::basic_string_view<CharT, Traits>{s});
+    }
 
-    template<std::size_t OtherMaxSize>
-    constexpr basic_inplace_string& assign(const basic_inplace_string<CharT, OtherMaxSize, Traits>& str)
+    template<std::size_t OtherMaxSize, typename OtherPolicy>
+    constexpr basic_inplace_string& assign(const basic_inplace_string<CharT, OtherMaxSize, Traits, OtherPolicy>& str)
     {
       return assign(str.data(), str.size());
     }
-    template<std::size_t OtherMaxSize>
-    constexpr basic_inplace_string& assign(const basic_inplace_string<CharT, OtherMaxSize, Traits>& str, size_type pos,
+    template<std::size_t OtherMaxSize, typename OtherPolicy>
+    constexpr basic_inplace_string& assign(const basic_inplace_string<CharT, OtherMaxSize, Traits, OtherPolicy>& str, size_type pos,
                                            size_type count = npos)
     {
       return assign(std::basic_string_view<CharT, Traits>{str}.substr(pos, count));
@@ -247,22 +1387,49 @@ namespace mp {
     {
       return assign(std::basic_string_view<CharT, Traits>{t}.substr(pos, count));
     }
-    constexpr basic_inplace_string& assign(const_pointer s, size_type count) noexcept
+    constexpr basic_inplace_string& assign(const_pointer s, size_type count) noexcept(nothrow_overflow)
     {
-      assert(count <= MaxSize);
+      count = fit(0, count, s);
+      traits_type::move(data(), s, count);  // 's' may point inside of this string
       size(count);
-      traits_type::copy(data(), s, count);
       return *this;
     }
-    constexpr basic_inplace_string& assign(const_pointer s) noexcept { return assign(s, traits_type::length(s)); };
+    template<typename Ptr, detail::Requires<std::is_convertible<Ptr, const_pointer>> = true>
+    constexpr basic_inplace_string& assign(Ptr s) noexcept(nothrow_overflow)
+    {
+      return assign(s, traits_type::length(s));
+    }
+    // Arrays of constant characters (string literals) have their size known at compile time so the content is
+    // copied with a fixed-size copy. Embedded zeros are still honoured with a scan bounded by the array size
+    // which the compiler folds for literals. Bigger arrays (e.g. fixed-size fields holding shorter strings) take
+    // the runtime path and its overflow policy.
+    template<std::size_t N>
+    constexpr basic_inplace_string& assign(const CharT (&s)[N]) noexcept(nothrow_overflow)
+    {
+      const auto zero = traits_type::find(s, N, value_type{});
+      const size_type len = zero ? static_cast<size_type>(zero - s) : N;
+      if constexpr(N - 1 <= MaxSize) {
+        if(len == N - 1) {
+          size(N - 1);
+          traits_type::copy(data(), s, N - 1);
+          return *this;
+        }
+      }
+      return assign(static_cast<const_pointer>(s), len);
+    }
+    // buffers of modifiable characters are treated as pointers as their content may be shorter than the array
+    template<std::size_t N>
+    constexpr basic_inplace_string& assign(CharT (&s)[N]) noexcept(nothrow_overflow)
+    {
+      return assign(static_cast<const_pointer>(s));
+    }
     constexpr basic_inplace_string& assign(std::initializer_list<CharT> ilist)
     {
       return assign(ilist.begin(), ilist.size());
     }
-    constexpr basic_inplace_string& assign(size_type count, CharT ch)
+    constexpr basic_inplace_string& assign(size_type count, CharT ch) noexcept(nothrow_overflow)
     {
-      assert(count < npos);
-      assert(count <= MaxSize);
+      count = fit(0, count);
       size(count);
       traits_type::assign(data(), count, ch);
       return *this;
@@ -270,8 +1437,8 @@ namespace mp {
     template<class InputIt, detail::Requires<std::negation<std::is_integral<InputIt>>> = true>
     constexpr basic_inplace_string& assign(InputIt first, InputIt last)
     {
-      size(std::distance(first, last));
-      traits_type::copy(data(), first, size());
+      size(fit(0, static_cast<size_type>(std::distance(first, last)), first));
+      std::copy_n(first, size(), data());
       return *this;
     }
     template<class InputIt, detail::Requires<std::is_integral<InputIt>> = true>
@@ -280,167 +1447,803 @@ namespace mp {
       return assign(static_cast<size_type>(first), static_cast<value_type>(last));
     }
 
+    // Appends the text of an integer like std::to_chars() (lowercase digits in 'base' from 2 to 36, '-' for
+    // negative values) right-aligned in a field of 'width' characters padded with 'fill'. A '0' fill goes between
+    // the sign and the digits. A number is never split: if it does not fit it is not appended at all, according to
+    // the overflow policy std::length_error is thrown or the error is reported in the result.
+    template<typename Int, detail::Requires<std::is_integral<Int>, std::is_signed<Int>> = true>
+    inplace_string_result append_int(Int value, size_type width = 0, value_type fill = value_type{'0'},
+                                     unsigned base = 10) noexcept(nothrow_overflow)
+    {
+      using unsigned_type = detail::digits::uint_t<Int>;
+      const bool negative = value < 0;
+      const auto bits = static_cast<unsigned_type>(value);
+      return append_digits(negative ? static_cast<unsigned_type>(0 - bits) : bits, negative, width, fill, base);
+    }
+    template<typename UInt, detail::Requires<std::is_integral<UInt>, std::is_unsigned<UInt>,
+                                             std::negation<std::is_same<UInt, bool>>> = true>
+    inplace_string_result append_uint(UInt value, size_type width = 0, value_type fill = value_type{'0'},
+                                      unsigned base = 10) noexcept(nothrow_overflow)
+    {
+      return append_digits(static_cast<detail::digits::uint_t<UInt>>(value), false, width, fill, base);
+    }
+
+#if defined(MP_INPLACE_STRING_FLOAT_TO_CHARS)
+    // Appends the text of a floating-point value like std::to_chars(): the shortest one that reads back to the same
+    // value or the one in 'fmt' format with 'precision' digits. Overflow is handled as in append_int().
+    template<typename Float, detail::Requires<std::is_floating_point<Float>> = true>
+    inplace_string_result append_float(Float value) noexcept(nothrow_overflow)
+    {
+      return append_chars([&](char* first, char* last) { return std::to_chars(first, last, value); });
+    }
+    template<typename Float, detail::Requires<std::is_floating_point<Float>> = true>
+    inplace_string_result append_float(Float value, std::chars_format fmt) noexcept(nothrow_overflow)
+    {
+      return append_chars([&](char* first, char* last) { return std::to_chars(first, last, value, fmt); });
+    }
+    template<typename Float, detail::Requires<std::is_floating_point<Float>> = true>
+    inplace_string_result append_float(Float value, std::chars_format fmt, int precision) noexcept(nothrow_overflow)
+    {
+      return append_chars([&](char* first, char* last) { return std::to_chars(first, last, value, fmt, precision); });
+    }
+#endif
+
+    // Non-throwing modifiers independent of the overflow policy: as many characters as fit are written
+    // (without splitting a code point for 'truncate_utf8' policy) and the already stored ones are never lost.
+    constexpr inplace_string_result try_assign(std::basic_string_view<CharT, Traits> sv) noexcept
+    {
+      const auto n = clamp(0, sv.size(), sv.data());
+      traits_type::move(data(), sv.data(), n);
+      size(n);
+      return result(n, sv.size());
+    }
+    constexpr inplace_string_result try_assign(size_type count, value_type c) noexcept
+    {
+      const auto n = clamp(0, count);
+      size(n);
+      traits_type::assign(data(), n, c);
+      return result(n, count);
+    }
+    inplace_string_result try_append(std::basic_string_view<CharT, Traits> sv) noexcept
+    {
+      const auto sz = size();
+      const auto n = clamp(sz, sv.size(), sv.data());
+      size(sz + n);
+      traits_type::copy(data() + sz, sv.data(), n);
+      return result(n, sv.size());
+    }
+    inplace_string_result try_append(size_type count, value_type c) noexcept
+    {
+      const auto sz = size();
+      const auto n = clamp(sz, count);
+      size(sz + n);
+      traits_type::assign(data() + sz, n, c);
+      return result(n, count);
+    }
+    inplace_string_result try_push_back(value_type c) noexcept { return try_append(1, c); }
+    // the count of the result is the number of the appended characters
+    constexpr inplace_string_result try_resize(size_type n, value_type c) noexcept
+    {
+      const auto sz = size();
+      if(n <= sz) {
+        size(n);
+        return result(0, 0);
+      }
+      const auto count = clamp(sz, n - sz);
+      size(sz + count);
+      traits_type::assign(data() + sz, count, c);
+      return result(count, n - sz);
+    }
+    constexpr inplace_string_result try_resize(size_type n) noexcept { return try_resize(n, value_type{}); }
+    inplace_string_result try_insert(size_type index, size_type count, value_type c) noexcept
+    {
+      if(index > size()) return {0, std::errc::invalid_argument};
+      const auto n = clamp(size(), count);
+      insert_chars(index, n, c);
+      return result(n, count);
+    }
+    inplace_string_result try_insert(size_type index, std::basic_string_view<CharT, Traits> sv) noexcept
+    {
+      if(index > size()) return {0, std::errc::invalid_argument};
+      const auto n = clamp(size(), sv.size(), sv.data());
+      insert_chars(index, sv.data(), n);
+      return result(n, sv.size());
+    }
+
     // string operations
     constexpr const_pointer c_str() const { return data(); }
-    constexpr pointer data() { return chars_.data(); }
-    constexpr const_pointer data() const { return chars_.data(); }
+    constexpr pointer data() { return chars_.data() + data_offset; }
+    constexpr const_pointer data() const { return chars_.data() + data_offset; }
     constexpr operator std::basic_string_view<CharT, Traits>() const noexcept
     {
       return {data(), size()};
     }
 
+    constexpr int compare(std::basic_string_view<CharT, Traits> sv) const noexcept
+    {
+      if(detail::is_constant_evaluated()) return std::basic_string_view<CharT, Traits>{*this}.compare(sv);
+      return string_kernels::compare(data(), size(), sv.data(), sv.size(), std::min(readable(), sv.size()));
+    }
+    template<std::size_t OtherMaxSize, typename OtherPolicy>
+    constexpr int compare(const basic_inplace_string<CharT, OtherMaxSize, Traits, OtherPolicy>& str) const noexcept
+    {
+      if(detail::is_constant_evaluated()) return std::basic_string_view<CharT, Traits>{*this}.compare(str);
+      return string_kernels::compare(data(), size(), str.data(), str.size(), std::min(readable(), str.readable()));
+    }
+    constexpr int compare(size_type pos1, size_type count1, std::basic_string_view<CharT, Traits> sv) const
+    {
+      return std::basic_string_view<CharT, Traits>{*this}.substr(pos1, count1).compare(sv);
+    }
+    constexpr int compare(size_type pos1, size_type count1, std::basic_string_view<CharT, Traits> sv, size_type pos2,
+                          size_type count2 = npos) const
+    {
+      return std::basic_string_view<CharT, Traits>{*this}.substr(pos1, count1).compare(sv.substr(pos2, count2));
+    }
+    constexpr int compare(const_pointer s) const { return compare(std::basic_string_view<CharT, Traits>{s}); }
+    constexpr int compare(size_type pos1, size_type count1, const_pointer s) const
+    {
+      return compare(pos1, count1, std::basic_string_view<CharT, Traits>{s});
+    }
+    constexpr int compare(size_type pos1, size_type count1, const_pointer s, size_type count2) const
+    {
+      return compare(pos1, count1, std::basic_string_view<CharT, Traits>{s, count2});
+    }
+
+    // search
+    constexpr size_type find(std::basic_string_view<CharT, Traits> sv, size_type pos = 0) const noexcept
+    {
+      return find(sv.data(), pos, sv.size());
+    }
+    constexpr size_type find(const_pointer s, size_type pos, size_type count) const noexcept
+    {
+      if(detail::is_constant_evaluated()) return std::basic_string_view<CharT, Traits>{*this}.find(s, pos, count);
+      return string_kernels::find(data(), size(), readable(), pos, s, count);
+    }
+    constexpr size_type find(const_pointer s, size_type pos = 0) const noexcept
+    {
+      return find(s, pos, traits_type::length(s));
+    }
+    constexpr size_type find(value_type ch, size_type pos = 0) const noexcept
+    {
+      if(detail::is_constant_evaluated()) return std::basic_string_view<CharT, Traits>{*this}.find(ch, pos);
+      return string_kernels::find(data(), size(), readable(), pos, ch);
+    }
+
+    constexpr size_type rfind(std::basic_string_view<CharT, Traits> sv, size_type pos = npos) const noexcept
+    {
+      return rfind(sv.data(), pos, sv.size());
+    }
+    constexpr size_type rfind(const_pointer s, size_type pos, size_type count) const noexcept
+    {
+      if(detail::is_constant_evaluated()) return std::basic_string_view<CharT, Traits>{*this}.rfind(s, pos, count);
+      return string_kernels::rfind(data(), size(), readable(), pos, s, count);
+    }
+    constexpr size_type rfind(const_pointer s, size_type pos = npos) const noexcept
+    {
+      return rfind(s, pos, traits_type::length(s));
+    }
+    constexpr size_type rfind(value_type ch, size_type pos = npos) const noexcept
+    {
+      if(detail::is_constant_evaluated()) return std::basic_string_view<CharT, Traits>{*this}.rfind(ch, pos);
+      return string_kernels::rfind(data(), size(), readable(), pos, ch);
+    }
+
+    constexpr size_type find_first_of(std::basic_string_view<CharT, Traits> sv, size_type pos = 0) const noexcept
+    {
+      return find_first_of(sv.data(), pos, sv.size());
+    }
+    constexpr size_type find_first_of(const_pointer s, size_type pos, size_type count) const noexcept
+    {
+      if(detail::is_constant_evaluated())
+        return std::basic_string_view<CharT, Traits>{*this}.find_first_of(s, pos, count);
+      return string_kernels::find_first_of(data(), size(), readable(), pos, s, count, false);
+    }
+    constexpr size_type find_first_of(const_pointer s, size_type pos = 0) const noexcept
+    {
+      return find_first_of(s, pos, traits_type::length(s));
+    }
+    constexpr size_type find_first_of(value_type ch, size_type pos = 0) const noexcept { return find(ch, pos); }
+
+    constexpr size_type find_last_of(std::basic_string_view<CharT, Traits> sv, size_type pos = npos) const noexcept
+    {
+      return find_last_of(sv.data(), pos, sv.size());
+    }
+    constexpr size_type find_last_of(const_pointer s, size_type pos, size_type count) const noexcept
+    {
+      if(detail::is_constant_evaluated())
+        return std::basic_string_view<CharT, Traits>{*this}.find_last_of(s, pos, count);
+      return string_kernels::find_last_of(data(), size(), readable(), pos, s, count, false);
+    }
+    constexpr size_type find_last_of(const_pointer s, size_type pos = npos) const noexcept
+    {
+      return find_last_of(s, pos, traits_type::length(s));
+    }
+    constexpr size_type find_last_of(value_type ch, size_type pos = npos) const noexcept { return rfind(ch, pos); }
+
+    constexpr size_type find_first_not_of(std::basic_string_view<CharT, Traits> sv, size_type pos = 0) const noexcept
+    {
+      return find_first_not_of(sv.data(), pos, sv.size());
+    }
+    constexpr size_type find_first_not_of(const_pointer s, size_type pos, size_type count) const noexcept
+    {
+      if(detail::is_constant_evaluated())
+        return std::basic_string_view<CharT, Traits>{*this}.find_first_not_of(s, pos, count);
+      return string_kernels::find_first_of(data(), size(), readable(), pos, s, count, true);
+    }
+    constexpr size_type find_first_not_of(const_pointer s, size_type pos = 0) const noexcept
+    {
+      return find_first_not_of(s, pos, traits_type::length(s));
+    }
+    constexpr size_type find_first_not_of(value_type ch, size_type pos = 0) const noexcept
+    {
+      return find_first_not_of(&ch, pos, 1);
+    }
+
+    constexpr size_type find_last_not_of(std::basic_string_view<CharT, Traits> sv, size_type pos = npos) const noexcept
+    {
+      return find_last_not_of(sv.data(), pos, sv.size());
+    }
+    constexpr size_type find_last_not_of(const_pointer s, size_type pos, size_type count) const noexcept
+    {
+      if(detail::is_constant_evaluated())
+        return std::basic_string_view<CharT, Traits>{*this}.find_last_not_of(s, pos, count);
+      return string_kernels::find_last_of(data(), size(), readable(), pos, s, count, true);
+    }
+    constexpr size_type find_last_not_of(const_pointer s, size_type pos = npos) const noexcept
+    {
+      return find_last_not_of(s, pos, traits_type::length(s));
+    }
+    constexpr size_type find_last_not_of(value_type ch, size_type pos = npos) const noexcept
+    {
+      return find_last_not_of(&ch, pos, 1);
+    }
+
+    // numeric conversions
+    // Parse the number at the beginning of the string like std::from_chars() (no whitespace, no '+' and no base
+    // prefix) without copying the characters; the count of the result is the number of the parsed characters.
+    template<typename Int, detail::Requires<std::is_integral<Int>, std::negation<std::is_same<Int, bool>>> = true>
+    inplace_string_result from_chars(Int& value, int base = 10) const noexcept
+    {
+      assert(base >= 2 && base <= 36);
+      using unsigned_type =
+          std::conditional_t<(sizeof(Int) <= sizeof(std::uint64_t)), std::uint64_t, std::make_unsigned_t<Int>>;
+      auto p = data();
+      const bool negative = std::is_signed_v<Int> && *p == value_type{'-'};
+      p += negative;
+      const auto digits = p;
+      while(*p == value_type{'0'}) ++p;
+      unsigned_type v = 0;
+      if(base == 10) p = detail::digits::read_decimal(p, data() + readable(), v, 19);
+      bool overflow = false;
+      for(unsigned d; (d = detail::digits::value(*p)) < static_cast<unsigned>(base); ++p) {
+        overflow = overflow || v > (std::numeric_limits<unsigned_type>::max() - d) / static_cast<unsigned>(base);
+        if(!overflow) v = v * static_cast<unsigned>(base) + d;
+      }
+      if(p == digits) return {0, std::errc::invalid_argument};
+      const auto count = static_cast<size_type>(p - data());
+      if(overflow || v > static_cast<unsigned_type>(std::numeric_limits<Int>::max()) + negative)
+        return {count, std::errc::result_out_of_range};
+      value = static_cast<Int>(negative ? 0 - v : v);
+      return {count, std::errc{}};
+    }
+#if defined(MP_INPLACE_STRING_FLOAT_TO_CHARS)
+    template<typename Float, detail::Requires<std::is_floating_point<Float>> = true>
+    inplace_string_result from_chars(Float& value, std::chars_format fmt = std::chars_format::general) const noexcept
+    {
+      if(fmt == std::chars_format::general) {
+        if(const auto count = detail::digits::parse_float(data(), data() + readable(), value))
+          return {count, std::errc{}};
+      }
+      if constexpr(sizeof(CharT) == 1) {
+        const auto first = reinterpret_cast<const char*>(data());
+        const auto [ptr, ec] = std::from_chars(first, first + size(), value, fmt);
+        return {static_cast<size_type>(ptr - first), ec};
+      }
+      else {
+        std::array<char, MaxSize> narrow;
+        size_type n = 0;
+        for(; n < size() && static_cast<detail::impl_size_type_helper<sizeof(CharT)>>(data()[n]) < 0x80; ++n)
+          narrow[n] = static_cast<char>(data()[n]);
+        const auto [ptr, ec] = std::from_chars(narrow.data(), narrow.data() + n, value, fmt);
+        return {static_cast<size_type>(ptr - narrow.data()), ec};
+      }
+    }
+#endif
+    // Converts the whole string to a number; 'args' are passed to from_chars().
+    template<typename T, typename... Args>
+    inplace_string_parse_result<T> parse(Args... args) const noexcept
+    {
+      T value{};
+      const auto res = from_chars(value, args...);
+      if(res.ec == std::errc{} && res.count != size()) return {T{}, std::errc::invalid_argument};
+      return {res.ec == std::errc{} ? value : T{}, res.ec};
+    }
+
     // modifiers
-    constexpr void swap(basic_inplace_string& other) { std::swap(chars_, other.chars_); }
+    constexpr void swap(basic_inplace_string& other)
+    {
+      if constexpr(bounded_copy) {
+        const basic_inplace_string tmp{other};
+        other = *this;
+        *this = tmp;
+      }
+      else
+        std::swap(chars_, other.chars_);
+    }
 
   private:
-    std::array<value_type, MaxSize + 1> chars_;  // size is stored as max_size() - size() on the last byte
+    template<typename, std::size_t, typename, typename>
+    friend class basic_inplace_string;
+    friend struct detail::inplace_string_access;
+
+    using string_kernels = detail::string_kernels<CharT, Traits>;
+
+    static constexpr bool nothrow_overflow = Policy::overflow != inplace_string_overflow::throw_exception;
+
+    static constexpr bool size_in_front = layout::size_in_front;
+    static constexpr size_type size_units = layout::size_units;
+    static constexpr size_type size_offset = layout::size_offset;
+    static constexpr size_type data_offset = layout::data_offset;
+    static constexpr size_type storage_units = layout::storage_units;
+    static constexpr bool bounded_copy = Policy::copy == inplace_string_copy::bounded;
+
+    // number of characters that can be safely loaded starting from data()
+    static constexpr size_type readable() noexcept { return storage_units - data_offset; }
+
+    using storage_base::chars_;
 
-    constexpr void size(size_type s)
+    constexpr impl_size_type stored_size() const noexcept { return layout::load_size(chars_.data()); }
+    constexpr void stored_size(impl_size_type v) noexcept { layout::store_size(chars_.data(), v); }
+
+    // establishes the zero padded tail invariant for a newly constructed empty string
+    constexpr void init() noexcept
+    {
+      if constexpr(Policy::zero_padded_tail) {
+        chars_ = {};
+        stored_size(static_cast<impl_size_type>(size_in_front ? 0 : max_size()));
+      }
+    }
+
+    // number of the 'count' characters to be stored after the first 'sz' ones that may be stored according to
+    // the overflow policy
+    constexpr size_type fit(size_type sz, size_type count) const noexcept(nothrow_overflow)
+    {
+      if constexpr(Policy::overflow == inplace_string_overflow::throw_exception) {
+        if(count > max_size() - sz) throw std::length_error("mp::basic_inplace_string: size() > max_size()");
+        return count;
+      }
+      else if constexpr(Policy::overflow == inplace_string_overflow::unchecked) {
+        assert(count <= max_size() - sz);
+        return count;
+      }
+      else {
+        return clamp(sz, count);
+      }
+    }
+    // as above but a truncated sequence of characters starting at 's' is not allowed to end in the middle of
+    // a code point for 'truncate_utf8' policy
+    template<typename InputIt>
+    constexpr size_type fit(size_type sz, size_type count, InputIt s) const noexcept(nothrow_overflow)
     {
-      if(s > max_size()) throw std::length_error("mp::basic_inplace_string: size() > max_size()");
-      chars_[s] = '\0';
-      chars_.back() = static_cast<impl_size_type>(max_size() - s);
+      if constexpr(nothrow_overflow && Policy::overflow != inplace_string_overflow::unchecked)
+        return clamp(sz, count, s);
+      else
+        return fit(sz, count);
+    }
+
+    // the truncating part of fit() also used by the try_* members regardless of the overflow policy
+    constexpr size_type clamp(size_type sz, size_type count) const noexcept { return std::min(count, max_size() - sz); }
+    template<typename InputIt>
+    constexpr size_type clamp(size_type sz, size_type count, InputIt s) const noexcept
+    {
+      auto n = clamp(sz, count);
+      if constexpr(Policy::overflow == inplace_string_overflow::truncate_utf8) {
+        if(n < count)
+          while(n > 0 && detail::is_continuation(static_cast<CharT>(*std::next(s, n)))) --n;
+      }
+      return n;
+    }
+
+    static constexpr inplace_string_result result(size_type written, size_type requested) noexcept
+    {
+      return {written, written == requested ? std::errc{} : std::errc::value_too_large};
+    }
+
+    // appends the characters written by 'to_chars(first, last)' straight to the free part of the storage
+    template<typename ToChars>
+    inplace_string_result append_chars(ToChars to_chars) noexcept(nothrow_overflow)
+    {
+      const auto sz = size();
+      const auto first = reinterpret_cast<char*>(data() + sz);
+      const auto [ptr, ec] = to_chars(first, first + (max_size() - sz) * sizeof(CharT));
+      // the free storage of wider characters has room for more narrow ones than fit
+      if(ec != std::errc{} || static_cast<size_type>(ptr - first) > max_size() - sz) {
+        // the written bytes (unspecified on failure) may have overwritten the terminator
+        if constexpr(Policy::zero_padded_tail) traits_type::assign(data() + sz, max_size() - sz, value_type{});
+        size(sz);
+        if constexpr(Policy::overflow == inplace_string_overflow::throw_exception)
+          throw std::length_error("mp::basic_inplace_string: size() > max_size()");
+        assert(Policy::overflow != inplace_string_overflow::unchecked);
+        return {0, std::errc::value_too_large};
+      }
+      const auto n = static_cast<size_type>(ptr - first);
+      // widened in place from the back so that every byte is read before it is overwritten
+      if constexpr(sizeof(CharT) > 1)
+        for(auto i = n; i-- > 0;) data()[sz + i] = static_cast<value_type>(first[i]);
+      size(sz + n);
+      return result(n, n);
+    }
+
+    template<typename UInt>
+    inplace_string_result append_digits(UInt v, bool negative, size_type width, value_type fill,
+                                        unsigned base) noexcept(nothrow_overflow)
+    {
+      assert(base >= 2 && base <= 36);
+      const auto digits = static_cast<size_type>(detail::digits::count(v, base));
+      const auto len = std::max<size_type>(width, digits + negative);
+      const auto sz = size();
+      if(fit(sz, len) < len) return result(0, len);
+      size(sz + len);
+      const auto first = data() + sz;
+      detail::digits::write(first + len, v, base);
+      const auto pad = len - digits - negative;
+      if(fill == value_type{'0'}) {
+        traits_type::assign(first + negative, pad, fill);
+        if(negative) *first = value_type{'-'};
+      }
+      else {
+        traits_type::assign(first, pad, fill);
+        if(negative) first[pad] = value_type{'-'};
+      }
+      return result(len, len);
+    }
+
+    // makes room for 'n' characters at 'index' and fills it with 'c'
+    void insert_chars(size_type index, size_type n, value_type c) noexcept
+    {
+      const auto sz = size();
+      size(sz + n);
+      traits_type::move(data() + index + n, data() + index, sz - index);
+      traits_type::assign(data() + index, n, c);
+    }
+    // makes room for 'n' characters at 'index' and copies them from 's' that may point inside of this string
+    void insert_chars(size_type index, const_pointer s, size_type n) noexcept
+    {
+      const auto sz = size();
+      std::array<value_type, MaxSize> copy;
+      if(std::less_equal<const_pointer>{}(data(), s) && std::less<const_pointer>{}(s, data() + sz)) {
+        traits_type::copy(copy.data(), s, n);
+        s = copy.data();
+      }
+      size(sz + n);
+      traits_type::move(data() + index + n, data() + index, sz - index);
+      traits_type::copy(data() + index, s, n);
+    }
+
+    constexpr void size(size_type s) noexcept
+    {
+      assert(s <= max_size());
+      if constexpr(Policy::zero_padded_tail) {
+        const auto sz = size();
+        if(s < sz) traits_type::assign(data() + s, sz - s, value_type{});
+      }
+      data()[s] = value_type{};
+      stored_size(static_cast<impl_size_type>(size_in_front ? s : max_size() - s));
     }
   };
 
   // relational operators
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  constexpr bool operator==(const basic_inplace_string<CharT, MaxSize, Traits>& lhs,
-                            const basic_inplace_string<CharT, MaxSize, Traits>& rhs)
+  template<typename CharT, std::size_t LhsMaxSize, std::size_t RhsMaxSize, class Traits, class LhsPolicy,
+           class RhsPolicy>
+  constexpr bool operator==(const basic_inplace_string<CharT, LhsMaxSize, Traits, LhsPolicy>& lhs,
+                            const basic_inplace_string<CharT, RhsMaxSize, Traits, RhsPolicy>& rhs) noexcept
   {
-    return std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs), std::end(rhs));
+    // with the zero padded tail whole buffers (including the size) can be compared at once
+    if constexpr(LhsMaxSize == RhsMaxSize && std::is_same<LhsPolicy, RhsPolicy>::value &&
+                 LhsPolicy::zero_padded_tail && std::is_same<Traits, std::char_traits<CharT>>::value) {
+      using access = detail::inplace_string_access;
+      constexpr std::size_t storage_bytes =
+          access::storage_size<basic_inplace_string<CharT, LhsMaxSize, Traits, LhsPolicy>>() * sizeof(CharT);
+      if(!detail::is_constant_evaluated())
+        return detail::equal_buffers<storage_bytes>(access::storage(lhs), access::storage(rhs));
+    }
+    return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
   }
 
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  constexpr bool operator!=(const basic_inplace_string<CharT, MaxSize, Traits>& lhs,
-                            const basic_inplace_string<CharT, MaxSize, Traits>& rhs)
+  template<typename CharT, std::size_t MaxSize, class Traits, class Policy>
+  constexpr bool operator==(const basic_inplace_string<CharT, MaxSize, Traits, Policy>& lhs,
+                            detail::type_identity_t<std::basic_string_view<CharT, Traits>> rhs) noexcept
   {
-    return !(lhs == rhs);
+    return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
   }
 
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  constexpr bool operator<(const basic_inplace_string<CharT, MaxSize, Traits>& lhs,
-                           const basic_inplace_string<CharT, MaxSize, Traits>& rhs)
+#if defined(MP_INPLACE_STRING_THREE_WAY_COMPARISON)
+
+  template<typename CharT, std::size_t LhsMaxSize, std::size_t RhsMaxSize, class Traits, class LhsPolicy,
+           class RhsPolicy>
+  constexpr auto operator<=>(const basic_inplace_string<CharT, LhsMaxSize, Traits, LhsPolicy>& lhs,
+                             const basic_inplace_string<CharT, RhsMaxSize, Traits, RhsPolicy>& rhs) noexcept
   {
-    return std::lexicographical_compare(std::begin(lhs), std::end(lhs), std::begin(rhs), std::end(rhs));
+    return static_cast<detail::comparison_category_t<Traits>>(lhs.compare(rhs) <=> 0);
   }
 
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  constexpr bool operator<=(const basic_inplace_string<CharT, MaxSize, Traits>& lhs,
-                            const basic_inplace_string<CharT, MaxSize, Traits>& rhs)
+  template<typename CharT, std::size_t MaxSize, class Traits, class Policy>
+  constexpr auto operator<=>(const basic_inplace_string<CharT, MaxSize, Traits, Policy>& lhs,
+                             detail::type_identity_t<std::basic_string_view<CharT, Traits>> rhs) noexcept
   {
-    return !(rhs < lhs);
+    return static_cast<detail::comparison_category_t<Traits>>(lhs.compare(rhs) <=> 0);
   }
 
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  constexpr bool operator>(const basic_inplace_string<CharT, MaxSize, Traits>& lhs,
-                           const basic_inplace_string<CharT, MaxSize, Traits>& rhs)
+#else
+
+  template<typename CharT, std::size_t LhsMaxSize, std::size_t RhsMaxSize, class Traits, class LhsPolicy,
+           class RhsPolicy>
+  constexpr bool operator!=(const basic_inplace_string<CharT, LhsMaxSize, Traits, LhsPolicy>& lhs,
+                            const basic_inplace_string<CharT, RhsMaxSize, Traits, RhsPolicy>& rhs) noexcept
   {
-    return rhs < lhs;
+    return !(lhs == rhs);
   }
 
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  constexpr bool operator>=(const basic_inplace_string<CharT, MaxSize, Traits>& lhs,
-                            const basic_inplace_string<CharT, MaxSize, Traits>& rhs)
+  template<typename CharT, std::size_t LhsMaxSize, std::size_t RhsMaxSize, class Traits, class LhsPolicy,
+           class RhsPolicy>
+  constexpr bool operator<(const basic_inplace_string<CharT, LhsMaxSize, Traits, LhsPolicy>& lhs,
+                           const basic_inplace_string<CharT, RhsMaxSize, Traits, RhsPolicy>& rhs) noexcept
   {
-    return !(lhs < rhs);
+    return lhs.compare(rhs) < 0;
   }
 
-  // comparison with c-style string
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  constexpr bool operator==(const CharT* lhs, const basic_inplace_string<CharT, MaxSize, Traits>& rhs)
+  template<typename CharT, std::size_t LhsMaxSize, std::size_t RhsMaxSize, class Traits, class LhsPolicy,
+           class RhsPolicy>
+  constexpr bool operator<=(const basic_inplace_string<CharT, LhsMaxSize, Traits, LhsPolicy>& lhs,
+                            const basic_inplace_string<CharT, RhsMaxSize, Traits, RhsPolicy>& rhs) noexcept
   {
-    return std::equal(lhs, lhs + Traits::length(lhs), std::begin(rhs), std::end(rhs));
+    return lhs.compare(rhs) <= 0;
   }
 
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  constexpr bool operator==(const basic_inplace_string<CharT, MaxSize, Traits>& lhs, const CharT* rhs)
+  template<typename CharT, std::size_t LhsMaxSize, std::size_t RhsMaxSize, class Traits, class LhsPolicy,
+           class RhsPolicy>
+  constexpr bool operator>(const basic_inplace_string<CharT, LhsMaxSize, Traits, LhsPolicy>& lhs,
+                           const basic_inplace_string<CharT, RhsMaxSize, Traits, RhsPolicy>& rhs) noexcept
   {
-    return std::equal(std::begin(lhs), std::end(lhs), rhs, rhs + Traits::length(rhs));
+    return lhs.compare(rhs) > 0;
   }
 
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  constexpr bool operator!=(const CharT* lhs, const basic_inplace_string<CharT, MaxSize, Traits>& rhs)
+  template<typename CharT, std::size_t LhsMaxSize, std::size_t RhsMaxSize, class Traits, class LhsPolicy,
+           class RhsPolicy>
+  constexpr bool operator>=(const basic_inplace_string<CharT, LhsMaxSize, Traits, LhsPolicy>& lhs,
+                            const basic_inplace_string<CharT, RhsMaxSize, Traits, RhsPolicy>& rhs) noexcept
   {
-    return !(lhs == rhs);
+    return lhs.compare(rhs) >= 0;
   }
 
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  constexpr bool operator!=(const basic_inplace_string<CharT, MaxSize, Traits>& lhs, const CharT* rhs)
+  // comparison with string views (and everything convertible to them, e.g. c-style strings)
+  template<typename CharT, std::size_t MaxSize, class Traits, class Policy>
+  constexpr bool operator==(detail::type_identity_t<std::basic_string_view<CharT, Traits>> lhs,
+                            const basic_inplace_string<CharT, MaxSize, Traits, Policy>& rhs) noexcept
+  {
+    return rhs == lhs;
+  }
+
+  template<typename CharT, std::size_t MaxSize, class Traits, class Policy>
+  constexpr bool operator!=(const basic_inplace_string<CharT, MaxSize, Traits, Policy>& lhs,
+                            detail::type_identity_t<std::basic_string_view<CharT, Traits>> rhs) noexcept
   {
     return !(lhs == rhs);
   }
 
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  constexpr bool operator<(const CharT* lhs, const basic_inplace_string<CharT, MaxSize, Traits>& rhs)
+  template<typename CharT, std::size_t MaxSize, class Traits, class Policy>
+  constexpr bool operator!=(detail::type_identity_t<std::basic_string_view<CharT, Traits>> lhs,
+                            const basic_inplace_string<CharT, MaxSize, Traits, Policy>& rhs) noexcept
+  {
+    return !(rhs == lhs);
+  }
+
+  template<typename CharT, std::size_t MaxSize, class Traits, class Policy>
+  constexpr bool operator<(const basic_inplace_string<CharT, MaxSize, Traits, Policy>& lhs,
+                           detail::type_identity_t<std::basic_string_view<CharT, Traits>> rhs) noexcept
   {
-    return std::lexicographical_compare(lhs, lhs + Traits::length(lhs), std::begin(rhs), std::end(rhs));
+    return lhs.compare(rhs) < 0;
   }
 
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  constexpr bool operator<(const basic_inplace_string<CharT, MaxSize, Traits>& lhs, const CharT* rhs)
+  template<typename CharT, std::size_t MaxSize, class Traits, class Policy>
+  constexpr bool operator<(detail::type_identity_t<std::basic_string_view<CharT, Traits>> lhs,
+                           const basic_inplace_string<CharT, MaxSize, Traits, Policy>& rhs) noexcept
   {
-    return std::lexicographical_compare(std::begin(lhs), std::end(lhs), rhs, rhs + Traits::length(rhs));
+    return rhs.compare(lhs) > 0;
   }
 
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  constexpr bool operator<=(const CharT* lhs, const basic_inplace_string<CharT, MaxSize, Traits>& rhs)
+  template<typename CharT, std::size_t MaxSize, class Traits, class Policy>
+  constexpr bool operator<=(const basic_inplace_string<CharT, MaxSize, Traits, Policy>& lhs,
+                            detail::type_identity_t<std::basic_string_view<CharT, Traits>> rhs) noexcept
   {
-    return !(rhs < lhs);
+    return lhs.compare(rhs) <= 0;
   }
 
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  constexpr bool operator<=(const basic_inplace_string<CharT, MaxSize, Traits>& lhs, const CharT* rhs)
+  template<typename CharT, std::size_t MaxSize, class Traits, class Policy>
+  constexpr bool operator<=(detail::type_identity_t<std::basic_string_view<CharT, Traits>> lhs,
+                            const basic_inplace_string<CharT, MaxSize, Traits, Policy>& rhs) noexcept
   {
-    return !(rhs < lhs);
+    return rhs.compare(lhs) >= 0;
   }
 
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  constexpr bool operator>(const CharT* lhs, const basic_inplace_string<CharT, MaxSize, Traits>& rhs)
+  template<typename CharT, std::size_t MaxSize, class Traits, class Policy>
+  constexpr bool operator>(const basic_inplace_string<CharT, MaxSize, Traits, Policy>& lhs,
+                           detail::type_identity_t<std::basic_string_view<CharT, Traits>> rhs) noexcept
   {
-    return rhs < lhs;
+    return lhs.compare(rhs) > 0;
   }
 
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  constexpr bool operator>(const basic_inplace_string<CharT, MaxSize, Traits>& lhs, const CharT* rhs)
+  template<typename CharT, std::size_t MaxSize, class Traits, class Policy>
+  constexpr bool operator>(detail::type_identity_t<std::basic_string_view<CharT, Traits>> lhs,
+                           const basic_inplace_string<CharT, MaxSize, Traits, Policy>& rhs) noexcept
   {
-    return rhs < lhs;
+    return rhs.compare(lhs) < 0;
   }
 
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  constexpr bool operator>=(const CharT* lhs, const basic_inplace_string<CharT, MaxSize, Traits>& rhs)
+  template<typename CharT, std::size_t MaxSize, class Traits, class Policy>
+  constexpr bool operator>=(const basic_inplace_string<CharT, MaxSize, Traits, Policy>& lhs,
+                            detail::type_identity_t<std::basic_string_view<CharT, Traits>> rhs) noexcept
   {
-    return !(lhs < rhs);
+    return lhs.compare(rhs) >= 0;
   }
 
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  constexpr bool operator>=(const basic_inplace_string<CharT, MaxSize, Traits>& lhs, const CharT* rhs)
+  template<typename CharT, std::size_t MaxSize, class Traits, class Policy>
+  constexpr bool operator>=(detail::type_identity_t<std::basic_string_view<CharT, Traits>> lhs,
+                            const basic_inplace_string<CharT, MaxSize, Traits, Policy>& rhs) noexcept
   {
-    return !(lhs < rhs);
+    return rhs.compare(lhs) <= 0;
   }
 
-  // input/output
-  template<typename CharT, std::size_t MaxSize, class Traits>
+#endif  // MP_INPLACE_STRING_THREE_WAY_COMPARISON
+
+  namespace detail {
+
+    template<typename Str>
+    struct inplace_string_policy;
+    template<typename CharT, std::size_t MaxSize, typename Traits, typename Policy>
+    struct inplace_string_policy<basic_inplace_string<CharT, MaxSize, Traits, Policy>> {
+      using type = Policy;
+    };
+
+  }  // namespace detail
+
+  // input/output (extraction, getline() and string streams are in <mp/inplace_string_stream.h>)
+  // written as std::basic_string_view so the size is not recomputed, embedded null characters are output and
+  // the width, fill and adjustment of the stream are still respected
+  template<typename CharT, std::size_t MaxSize, class Traits, class Policy>
   inline std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os,
-                                                       const basic_inplace_string<CharT, MaxSize, Traits>& v)
+                                                       const basic_inplace_string<CharT, MaxSize, Traits, Policy>& v)
   {
-    return os << v.data();
+    return os << std::basic_string_view<CharT, Traits>{v};
   }
 
   // conversions
-  template<typename CharT, std::size_t MaxSize, class Traits>
-  inline std::basic_string<CharT, Traits> to_string(const basic_inplace_string<CharT, MaxSize, Traits>& v)
+  template<typename CharT, std::size_t MaxSize, class Traits, class Policy>
+  inline std::basic_string<CharT, Traits> to_string(const basic_inplace_string<CharT, MaxSize, Traits, Policy>& v)
   {
     return {v.data(), v.size()};
   }
 
+  // Moving and destroying basic_inplace_string never does more than copying its bytes (copying does the same unless
+  // the bounded copy policy is used), so arrays of strings may be relocated with memcpy() and skip destruction.
+  template<typename T>
+  struct is_trivially_relocatable : std::conjunction<std::is_trivially_copyable<T>, std::is_trivially_destructible<T>> {
+  };
+  template<typename T>
+  inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+  template<typename CharT, std::size_t MaxSize, typename Traits, typename Policy>
+  struct is_trivially_relocatable<basic_inplace_string<CharT, MaxSize, Traits, Policy>> : std::true_type {
+    static_assert(std::is_trivially_copyable<basic_inplace_string<CharT, MaxSize, Traits, Policy>>::value ||
+                      Policy::copy == inplace_string_copy::bounded,
+                  "basic_inplace_string has to be trivially copyable");
+    static_assert(std::is_trivially_destructible<basic_inplace_string<CharT, MaxSize, Traits, Policy>>::value,
+                  "basic_inplace_string has to be trivially destructible");
+  };
+
+  // Fixed-size heap array of strings constructed with the 'uninitialized' tag: allocating it does not touch the
+  // memory (unless zero padded strings are stored). Elements have to be assigned before they are read.
+  template<typename Str>
+  class basic_uninitialized_inplace_array {
+    static_assert(is_trivially_relocatable_v<Str>, "Elements have to be trivially relocatable");
+
+  public:
+    using value_type = Str;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = Str&;
+    using const_reference = const Str&;
+    using pointer = Str*;
+    using const_pointer = const Str*;
+    using iterator = Str*;
+    using const_iterator = const Str*;
+
+    basic_uninitialized_inplace_array() = default;
+    explicit basic_uninitialized_inplace_array(size_type count)
+        : data_{std::allocator<Str>{}.allocate(count)}, size_{count}
+    {
+      for(size_type i = 0; i < count; ++i) ::new(static_cast<void*>(data_ + i)) Str(uninitialized);
+    }
+    basic_uninitialized_inplace_array(basic_uninitialized_inplace_array&& other) noexcept
+        : data_{std::exchange(other.data_, nullptr)}, size_{std::exchange(other.size_, 0)}
+    {
+    }
+    basic_uninitialized_inplace_array& operator=(basic_uninitialized_inplace_array&& other) noexcept
+    {
+      basic_uninitialized_inplace_array tmp{std::move(other)};
+      swap(tmp);
+      return *this;
+    }
+    ~basic_uninitialized_inplace_array()
+    {
+      if(data_) std::allocator<Str>{}.deallocate(data_, size_);
+    }
+
+    iterator begin() noexcept { return data_; }
+    const_iterator begin() const noexcept { return data_; }
+    iterator end() noexcept { return data_ + size_; }
+    const_iterator end() const noexcept { return data_ + size_; }
+
+    reference operator[](size_type pos) noexcept { return data_[pos]; }
+    const_reference operator[](size_type pos) const noexcept { return data_[pos]; }
+    pointer data() noexcept { return data_; }
+    const_pointer data() const noexcept { return data_; }
+    size_type size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    void swap(basic_uninitialized_inplace_array& other) noexcept
+    {
+      std::swap(data_, other.data_);
+      std::swap(size_, other.size_);
+    }
+
+  private:
+    Str* data_ = nullptr;
+    size_type size_ = 0;
+  };
+
   // aliases
   template<std::size_t MaxSize>
   using inplace_string = basic_inplace_string<char, MaxSize>;
   template<std::size_t MaxSize>
   using inplace_wstring = basic_inplace_string<wchar_t, MaxSize>;
-  //  template<std::size_t MaxSize>
-  //  using inplace_u16string = basic_inplace_string<char16_t, MaxSize>;
-  //  template<std::size_t MaxSize>
-  //  using inplace_u32string = basic_inplace_string<char32_t, MaxSize>;
+  template<std::size_t MaxSize>
+  using padded_inplace_string =
+      basic_inplace_string<char, MaxSize, std::char_traits<char>, zero_padded_inplace_string_policy>;
+  template<std::size_t MaxSize, std::size_t Alignment = 16>
+  using aligned_inplace_string =
+      basic_inplace_string<char, MaxSize, std::char_traits<char>, aligned_inplace_string_policy<Alignment>>;
+  template<std::size_t MaxSize>
+  using bounded_copy_inplace_string =
+      basic_inplace_string<char, MaxSize, std::char_traits<char>, bounded_copy_inplace_string_policy>;
+  template<std::size_t MaxSize>
+  using inplace_u16string = basic_inplace_string<char16_t, MaxSize>;
+  template<std::size_t MaxSize>
+  using inplace_u32string = basic_inplace_string<char32_t, MaxSize>;
+  template<std::size_t MaxSize>
+  using uninitialized_inplace_array = basic_uninitialized_inplace_array<inplace_string<MaxSize>>;
+}
+
+namespace std {
+
+  // Content based hash unless the zero padded tail policy is used. In such a case the whole buffer is hashed
+  // with a fixed-length branch-free kernel. Results differ from std::hash<std::basic_string_view>.
+  template<typename CharT, std::size_t MaxSize, typename Policy>
+  struct hash<mp::basic_inplace_string<CharT, MaxSize, std::char_traits<CharT>, Policy>> {
+    constexpr std::size_t operator()(
+        const mp::basic_inplace_string<CharT, MaxSize, std::char_traits<CharT>, Policy>& str) const noexcept
+    {
+      constexpr std::size_t max_bytes = MaxSize * sizeof(CharT);
+      using access = mp::detail::inplace_string_access;
+      if constexpr(Policy::zero_padded_tail) {
+        constexpr std::size_t storage_bytes =
+            access::storage_size<mp::basic_inplace_string<CharT, MaxSize, std::char_traits<CharT>, Policy>>() *
+            sizeof(CharT);
+        return static_cast<std::size_t>(mp::detail::hash::bytes<storage_bytes>(access::storage(str), storage_bytes));
+      }
+      else
+        return static_cast<std::size_t>(mp::detail::hash::bytes<max_bytes>(str.data(), str.size() * sizeof(CharT)));
+    }
+  };
+
 }
@@ -0,0 +1,419 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_string.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mp {
+
+  // comparison done by match_all()
+  enum class inplace_string_match { equal, starts_with, ends_with };
+
+  namespace detail {
+
+    // strings of single byte characters with the standard traits are ordered by their unsigned bytes
+    template<typename T>
+    struct is_radix_sortable : std::false_type {
+    };
+    template<typename CharT, std::size_t MaxSize, typename Policy>
+    struct is_radix_sortable<basic_inplace_string<CharT, MaxSize, std::char_traits<CharT>, Policy>>
+        : std::bool_constant<sizeof(CharT) == 1> {
+    };
+
+    // equality of characters with the standard traits is equality of their bytes
+    template<typename T>
+    struct is_byte_comparable : std::false_type {
+    };
+    template<typename CharT, std::size_t MaxSize, typename Policy>
+    struct is_byte_comparable<basic_inplace_string<CharT, MaxSize, std::char_traits<CharT>, Policy>> : std::true_type {
+    };
+
+    // iterators known to address one array (vector code reads such a range as one block of memory)
+#if defined(__cpp_lib_concepts)
+    template<typename It>
+    struct is_contiguous_iterator : std::bool_constant<std::contiguous_iterator<It>> {
+    };
+#else
+    template<typename It, typename T = typename std::iterator_traits<It>::value_type>
+    struct is_contiguous_iterator
+        : std::bool_constant<std::is_pointer<It>::value || std::is_same<It, typename std::vector<T>::iterator>::value ||
+                             std::is_same<It, typename std::vector<T>::const_iterator>::value> {
+    };
+#endif
+
+    namespace radix {
+
+      constexpr std::size_t buckets = 257;  // end of string + all byte values
+      constexpr std::ptrdiff_t insertion_sort_threshold = 32;
+      // Nested bucket splits after which a range is finished with a comparison sort. Every level keeps its
+      // bucket arrays (a few KB) on the stack and long common prefixes could otherwise nest one level per
+      // character position.
+      constexpr std::size_t max_recursion = 16;
+
+      template<typename Str>
+      inline unsigned key(const Str& str, std::size_t depth) noexcept
+      {
+        return depth < str.size() ? static_cast<unsigned char>(str[depth]) + 1u : 0u;
+      }
+
+      // all the strings in the range share the first 'depth' characters
+      template<typename Str>
+      inline bool less(const Str& lhs, const Str& rhs, std::size_t depth) noexcept
+      {
+        using view = std::basic_string_view<typename Str::value_type, typename Str::traits_type>;
+        return view{lhs.data() + depth, lhs.size() - depth} < view{rhs.data() + depth, rhs.size() - depth};
+      }
+
+      template<typename It, typename Proj>
+      void insertion_sort(It first, It last, std::size_t depth, Proj proj)
+      {
+        if(first == last) return;
+        for(It i = std::next(first); i != last; ++i) {
+          auto value = std::move(*i);
+          It j = i;
+          for(; j != first && less(proj(value), proj(*std::prev(j)), depth); --j) *j = std::move(*std::prev(j));
+          *j = std::move(value);
+        }
+      }
+
+      // Counts keys of the range at 'depth'. Returns false if all of them landed in the same bucket.
+      template<typename It, typename Proj>
+      bool histogram(It first, It last, std::size_t depth, Proj proj, std::size_t (&count)[buckets],
+                     std::uint16_t* keys)
+      {
+        std::fill(std::begin(count), std::end(count), std::size_t{0});
+        for(It it = first; it != last; ++it, ++keys)
+          ++count[*keys = static_cast<std::uint16_t>(key(proj(*it), depth))];
+        return count[key(proj(*first), depth)] != static_cast<std::size_t>(last - first);
+      }
+
+      // in-place (American flag) MSD radix sort; not stable
+      template<typename It, typename Proj>
+      void american_flag_sort(It first, It last, std::size_t depth, std::size_t max_depth, Proj proj,
+                              std::uint16_t* keys, std::size_t level = 0)
+      {
+        if(level == max_recursion) {
+          std::sort(first, last, [&](const auto& a, const auto& b) { return less(proj(a), proj(b), depth); });
+          return;
+        }
+        std::size_t count[buckets];
+        while(last - first >= insertion_sort_threshold && depth < max_depth) {
+          if(!histogram(first, last, depth, proj, count, keys)) {
+            // common prefix - nothing to move
+            if(key(proj(*first), depth) == 0) return;
+            ++depth;
+            continue;
+          }
+
+          std::size_t next[buckets], end[buckets];
+          std::size_t offset = 0;
+          for(std::size_t b = 0; b < buckets; ++b) {
+            next[b] = offset;
+            offset += count[b];
+            end[b] = offset;
+          }
+          for(std::size_t b = 0; b < buckets; ++b) {
+            while(next[b] < end[b]) {
+              auto k = keys[next[b]];
+              while(k != b) {
+                const auto dest = next[k]++;
+                std::iter_swap(first + next[b], first + dest);
+                std::swap(k, keys[dest]);
+              }
+              keys[next[b]++] = static_cast<std::uint16_t>(b);
+            }
+          }
+
+          for(std::size_t b = 1, begin = count[0]; b < buckets; begin += count[b++])
+            if(count[b] > 1)
+              american_flag_sort(first + begin, first + begin + count[b], depth + 1, max_depth, proj, keys, level + 1);
+          return;
+        }
+        insertion_sort(first, last, depth, proj);
+      }
+
+      // MSD radix sort distributing through a buffer; stable
+      template<typename It, typename Buffer, typename Proj>
+      void stable_sort(It first, It last, Buffer buffer, std::size_t depth, std::size_t max_depth, Proj proj,
+                       std::uint16_t* keys, std::size_t level = 0)
+      {
+        if(level == max_recursion) {
+          std::stable_sort(first, last, [&](const auto& a, const auto& b) { return less(proj(a), proj(b), depth); });
+          return;
+        }
+        std::size_t count[buckets];
+        while(last - first >= insertion_sort_threshold && depth < max_depth) {
+          if(!histogram(first, last, depth, proj, count, keys)) {
+            if(key(proj(*first), depth) == 0) return;
+            ++depth;
+            continue;
+          }
+
+          std::size_t next[buckets];
+          std::size_t offset = 0;
+          for(std::size_t b = 0; b < buckets; ++b) {
+            next[b] = offset;
+            offset += count[b];
+          }
+          const auto n = last - first;
+          for(std::ptrdiff_t i = 0; i < n; ++i) buffer[next[keys[i]]++] = std::move(first[i]);
+          std::move(buffer, buffer + n, first);
+
+          for(std::size_t b = 1, begin = count[0]; b < buckets; begin += count[b++])
+            if(count[b] > 1)
+              stable_sort(first + begin, first + begin + count[b], buffer, depth + 1, max_depth, proj, keys, level + 1);
+          return;
+        }
+        insertion_sort(first, last, depth, proj);
+      }
+
+      struct identity {
+        template<typename T>
+        constexpr const T& operator()(const T& t) const noexcept
+        {
+          return t;
+        }
+      };
+
+    }  // namespace radix
+
+    namespace match {
+
+      template<typename Str>
+      using view_t = std::basic_string_view<typename Str::value_type, typename Str::traits_type>;
+
+      template<typename Str>
+      bool scalar(const Str& str, view_t<Str> needle, inplace_string_match mode) noexcept
+      {
+        const view_t<Str> s{str};
+        switch(mode) {
+          case inplace_string_match::equal: return s == needle;
+          case inplace_string_match::starts_with: return s.substr(0, needle.size()) == needle;
+          default: return s.size() >= needle.size() && s.substr(s.size() - needle.size()) == needle;
+        }
+      }
+
+      // writes 'pred(i)' for i in [0, n) as a bitmask and returns the number of matches
+      template<typename Pred>
+      std::size_t fill_bitmask(std::size_t n, std::uint64_t* bitmask, Pred pred)
+      {
+        std::size_t count = 0;
+        for(std::size_t base = 0; base < n; base += 64) {
+          const auto k = std::min<std::size_t>(64, n - base);
+          std::uint64_t word = 0;
+          for(std::size_t j = 0; j < k; ++j) word |= std::uint64_t{pred(base + j)} << j;
+          bitmask[base / 64] = word;
+          for(; word; word &= word - 1) ++count;
+        }
+        return count;
+      }
+
+#if defined(MP_INPLACE_STRING_SSE2)
+      // Characters of a candidate are compared with vector loads against a zero-padded copy of the needle and
+      // combined with the size check without branches when the needle fits in one vector. As the array is
+      // contiguous, loads may run past the end of an object into the next one; only the last few candidates, for
+      // which they could run past the end of the array, are compared without vectors. Strings taking up at most
+      // half of a vector (and a divisor of its width) are compared several per load for 'equal' and
+      // 'starts_with' against copies of a string holding the needle.
+      template<inplace_string_match Mode, typename V, typename CharT, std::size_t MaxSize, typename Traits,
+               typename Policy>
+      std::size_t vector_scan(const basic_inplace_string<CharT, MaxSize, Traits, Policy>* first, std::size_t n,
+                              std::basic_string_view<CharT, Traits> needle, std::uint64_t* bitmask)
+      {
+        using Str = basic_inplace_string<CharT, MaxSize, Traits, Policy>;
+        constexpr std::size_t char_size = sizeof(CharT);
+        constexpr std::size_t max_bytes = MaxSize * char_size;
+        constexpr std::size_t data_offset = inplace_string_access::data_offset<Str>() * char_size;
+        constexpr std::size_t reach = data_offset + max_bytes + V::width;  // furthest byte read from a candidate
+
+        const auto m = needle.size();
+        const auto needle_bytes = m * char_size;
+        const auto chunks = (needle_bytes + V::width - 1) / V::width;
+        alignas(32) unsigned char value[max_bytes + V::width] = {};
+        if(m) std::memcpy(value, needle.data(), needle_bytes);
+        const auto last_care = low_bits(needle_bytes - (chunks ? chunks - 1 : 0) * V::width);
+
+        const auto bytes = n * sizeof(Str);
+        const auto safe = bytes >= reach ? std::min(n, (bytes - reach) / sizeof(Str) + 1) : 0;
+        const auto base = reinterpret_cast<const unsigned char*>(first);
+
+        constexpr std::size_t rows =
+            Mode != inplace_string_match::ends_with && V::width % sizeof(Str) == 0 ? V::width / sizeof(Str) : 1;
+        using layout = inplace_string_layout<CharT, MaxSize, Policy>;
+        alignas(32) unsigned char pattern[V::width] = {};
+        auto row_care = low_bits(needle_bytes) << data_offset;
+        // for 'equal' the stored size is compared together with the characters
+        if constexpr(rows > 1) {
+          const Str ref{needle};
+          for(std::size_t r = 0; r < rows; ++r) std::memcpy(pattern + r * sizeof(Str), &ref, sizeof(Str));
+          if constexpr(Mode == inplace_string_match::equal)
+            row_care |= low_bits(layout::size_units * char_size) << (layout::size_offset * char_size);
+        }
+        const auto batched = n / rows * rows;
+        std::uint32_t group = 0;
+
+        // called for consecutive indices so the mask of the group of 'rows' strings is loaded at its first one
+        return fill_bitmask(n, bitmask, [&](std::size_t i) {
+          if constexpr(rows > 1) {
+            if(i < batched) {
+              const auto r = i % rows;
+              if(r == 0) group = V::eq(V::load(base + i * sizeof(Str)), V::load(pattern));
+              const bool chars_ok = (group >> (r * sizeof(Str)) & row_care) == row_care;
+              if constexpr(Mode == inplace_string_match::equal)
+                return chars_ok;
+              else
+                return chars_ok && first[i].size() >= m;
+            }
+          }
+          const Str& str = first[i];
+          const auto size = str.size();
+          const bool size_ok = Mode == inplace_string_match::equal ? size == m : size >= m;
+          if(i >= safe) return size_ok && scalar(str, needle, Mode);
+          auto p = base + i * sizeof(Str) + data_offset;
+          if(Mode == inplace_string_match::ends_with) p += (size_ok ? size - m : 0) * char_size;
+          if(chunks <= 1)  // branchless as sizes of the rows are usually unpredictable
+            return static_cast<bool>(size_ok & ((V::eq(V::load(p), V::load(value)) & last_care) == last_care));
+          if(!size_ok) return false;
+          for(std::size_t c = 0; c + 1 < chunks; ++c)
+            if(V::eq(V::load(p + c * V::width), V::load(value + c * V::width)) != low_bits(V::width)) return false;
+          const auto offset = (chunks - 1) * V::width;
+          return (V::eq(V::load(p + offset), V::load(value + offset)) & last_care) == last_care;
+        });
+      }
+#endif
+
+    }  // namespace match
+
+  }  // namespace detail
+
+  // Sorts a contiguous range of basic_inplace_string with an in-place MSD radix sort (American flag sort) working
+  // on one character position at a time and finishing small buckets with insertion sort (and deeply nested ones
+  // with std::sort). Not stable.
+  // Ranges of other types fall back to std::sort.
+  template<typename RandomIt>
+  void radix_sort(RandomIt first, RandomIt last)
+  {
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    if constexpr(detail::is_radix_sortable<value_type>::value) {
+      if(last - first < 2) return;
+      std::vector<std::uint16_t> keys(static_cast<std::size_t>(last - first));
+      detail::radix::american_flag_sort(first, last, 0, value_type{}.max_size(), detail::radix::identity{},
+                                        keys.data());
+    }
+    else {
+      std::sort(first, last);
+    }
+  }
+
+  // Stable MSD radix sort; needs a temporary buffer of the size of the range.
+  template<typename RandomIt>
+  void stable_radix_sort(RandomIt first, RandomIt last)
+  {
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    if constexpr(detail::is_radix_sortable<value_type>::value) {
+      if(last - first < 2) return;
+      const auto n = static_cast<std::size_t>(last - first);
+      std::vector<std::uint16_t> keys(n);
+      std::vector<value_type> buffer(n);
+      detail::radix::stable_sort(first, last, buffer.begin(), 0, value_type{}.max_size(), detail::radix::identity{},
+                                 keys.data());
+    }
+    else {
+      std::stable_sort(first, last);
+    }
+  }
+
+  // Index sort: writes to 'indices' the permutation of [0, last - first) that orders the range (stable) while the
+  // strings themselves are not moved. Only 4-byte indices are shuffled instead of MaxSize + 1 bytes long strings.
+  template<typename RandomIt, typename IndexIt>
+  void radix_sort_indices(RandomIt first, RandomIt last, IndexIt indices)
+  {
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    const auto n = static_cast<std::size_t>(last - first);
+    for(std::size_t i = 0; i < n; ++i) indices[i] = static_cast<std::uint32_t>(i);
+    if(n < 2) return;
+    const auto proj = [first](std::uint32_t i) -> const value_type& { return first[i]; };
+    if constexpr(detail::is_radix_sortable<value_type>::value) {
+      std::vector<std::uint16_t> keys(n);
+      std::vector<std::uint32_t> buffer(n);
+      detail::radix::stable_sort(indices, indices + n, buffer.begin(), 0, value_type{}.max_size(), proj, keys.data());
+    }
+    else {
+      std::stable_sort(indices, indices + n, [&](std::uint32_t a, std::uint32_t b) { return proj(a) < proj(b); });
+    }
+  }
+
+  // Batch comparison of one needle against a range of strings (a table scan): bit 'i % 64' of
+  // 'bitmask[i / 64]' is set when the element 'i' is equal to, starts with or ends with the needle.
+  // '(last - first + 63) / 64' words are written (unused high bits of the last one are cleared).
+  // Returns the number of matching elements. Characters of basic_inplace_string elements with the standard
+  // character traits are compared with SSE2/AVX2 vectors after their sizes when the iterators address one array
+  // (pointers, std::vector iterators or, with C++20, any contiguous iterator); other ranges are compared one
+  // element at a time.
+  template<typename RandomIt, typename CharT, typename Traits>
+  std::size_t match_all(std::basic_string_view<CharT, Traits> needle, RandomIt first, RandomIt last,
+                        std::uint64_t* bitmask, inplace_string_match mode = inplace_string_match::equal)
+  {
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    const auto n = static_cast<std::size_t>(last - first);
+    if(needle.size() > value_type{}.max_size())
+      return detail::match::fill_bitmask(n, bitmask, [](std::size_t) { return false; });
+#if defined(MP_INPLACE_STRING_SSE2)
+    if constexpr(detail::is_byte_comparable<value_type>::value && detail::is_contiguous_iterator<RandomIt>::value) {
+#if defined(MP_INPLACE_STRING_AVX2)
+      using V = detail::simd::avx2<>;
+#else
+      using V = detail::simd::sse2<>;
+#endif
+      const auto p = n ? std::addressof(first[0]) : nullptr;
+      switch(mode) {
+        case inplace_string_match::equal:
+          return detail::match::vector_scan<inplace_string_match::equal, V>(p, n, needle, bitmask);
+        case inplace_string_match::starts_with:
+          return detail::match::vector_scan<inplace_string_match::starts_with, V>(p, n, needle, bitmask);
+        default: return detail::match::vector_scan<inplace_string_match::ends_with, V>(p, n, needle, bitmask);
+      }
+    }
+#endif
+    return detail::match::fill_bitmask(
+        n, bitmask, [&](std::size_t i) { return detail::match::scalar(first[i], needle, mode); });
+  }
+
+  template<typename RandomIt, typename CharT, std::size_t MaxSize, typename Traits, typename Policy>
+  std::size_t match_all(const basic_inplace_string<CharT, MaxSize, Traits, Policy>& needle, RandomIt first,
+                        RandomIt last, std::uint64_t* bitmask, inplace_string_match mode = inplace_string_match::equal)
+  {
+    return match_all(std::basic_string_view<CharT, Traits>{needle}, first, last, bitmask, mode);
+  }
+
+}  // namespace mp
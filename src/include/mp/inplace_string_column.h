@@ -0,0 +1,374 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_string.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mp {
+
+  namespace detail {
+
+    namespace column {
+
+      // calls 'f(i)' for every 'i' with 'lo <= sizes[i] <= hi'
+      template<typename SizeT, typename F>
+      void scan_sizes(const SizeT* sizes, std::size_t n, SizeT lo, SizeT hi, F f)
+      {
+        std::size_t i = 0;
+#if defined(MP_INPLACE_STRING_SSE2)
+        // one byte lengths (MaxSize < 256): 16 rows per unsigned min/max test
+        if constexpr(sizeof(SizeT) == 1) {
+          const auto vlo = _mm_set1_epi8(static_cast<char>(lo));
+          const auto vhi = _mm_set1_epi8(static_cast<char>(hi));
+          for(; i + 16 <= n; i += 16) {
+            const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sizes + i));
+            const auto in_range =
+                _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(v, vlo), v), _mm_cmpeq_epi8(_mm_min_epu8(v, vhi), v));
+            for(auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(in_range)); mask; mask &= mask - 1)
+              f(i + countr_zero(mask));
+          }
+        }
+#endif
+        for(; i < n; ++i)
+          if(lo <= sizes[i] && sizes[i] <= hi) f(i);
+      }
+
+    }  // namespace column
+
+  }  // namespace detail
+
+  // Struct-of-arrays container of fixed-capacity strings. Characters of all the strings are kept in one contiguous
+  // slab of 'MaxSize' characters per row (unused characters are zeroed) and their lengths in a separate compact
+  // array, so scans that only look at lengths touch a small fraction of the memory. Elements are exposed as string
+  // views into the slab; 'get()' materializes a basic_inplace_string. Views and iterators are invalidated by any
+  // operation that changes the number of rows.
+  template<typename CharT, std::size_t MaxSize, typename Traits = std::char_traits<CharT>>
+  class basic_inplace_string_column {
+  public:
+    using value_type = basic_inplace_string<CharT, MaxSize, Traits>;
+    using string_view_type = std::basic_string_view<CharT, Traits>;
+    using length_type = detail::uint_least_t<MaxSize>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = string_view_type;
+    using const_reference = string_view_type;
+
+    class const_iterator {
+      friend class basic_inplace_string_column;
+      const basic_inplace_string_column* column_ = nullptr;
+      size_type index_ = 0;
+
+      const_iterator(const basic_inplace_string_column* column, size_type index) noexcept
+          : column_{column}, index_{index}
+      {
+      }
+
+    public:
+      using iterator_category = std::random_access_iterator_tag;
+      using value_type = string_view_type;
+      using difference_type = basic_inplace_string_column::difference_type;
+      using reference = string_view_type;
+      using pointer = void;
+
+      const_iterator() = default;
+
+      reference operator*() const noexcept { return (*column_)[index_]; }
+      reference operator[](difference_type n) const noexcept { return (*column_)[index_ + n]; }
+      size_type index() const noexcept { return index_; }
+
+      const_iterator& operator++() noexcept
+      {
+        ++index_;
+        return *this;
+      }
+      const_iterator operator++(int) noexcept { return {column_, index_++}; }
+      const_iterator& operator--() noexcept
+      {
+        --index_;
+        return *this;
+      }
+      const_iterator operator--(int) noexcept { return {column_, index_--}; }
+      const_iterator& operator+=(difference_type n) noexcept
+      {
+        index_ += n;
+        return *this;
+      }
+      const_iterator& operator-=(difference_type n) noexcept
+      {
+        index_ -= n;
+        return *this;
+      }
+      friend const_iterator operator+(const_iterator it, difference_type n) noexcept { return it += n; }
+      friend const_iterator operator+(difference_type n, const_iterator it) noexcept { return it += n; }
+      friend const_iterator operator-(const_iterator it, difference_type n) noexcept { return it -= n; }
+      friend difference_type operator-(const const_iterator& lhs, const const_iterator& rhs) noexcept
+      {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+      }
+
+      friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) noexcept
+      {
+        return lhs.index_ == rhs.index_;
+      }
+      friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) noexcept { return !(lhs == rhs); }
+      friend bool operator<(const const_iterator& lhs, const const_iterator& rhs) noexcept
+      {
+        return lhs.index_ < rhs.index_;
+      }
+      friend bool operator>(const const_iterator& lhs, const const_iterator& rhs) noexcept { return rhs < lhs; }
+      friend bool operator<=(const const_iterator& lhs, const const_iterator& rhs) noexcept { return !(rhs < lhs); }
+      friend bool operator>=(const const_iterator& lhs, const const_iterator& rhs) noexcept { return !(lhs < rhs); }
+    };
+    using iterator = const_iterator;
+
+    // number of characters reserved for every row
+    static constexpr size_type stride = MaxSize;
+
+    // constructors
+    basic_inplace_string_column() : chars_(padding) {}
+    basic_inplace_string_column(std::initializer_list<string_view_type> ilist) : basic_inplace_string_column()
+    {
+      reserve(ilist.size());
+      for(const auto& s : ilist) push_back(s);
+    }
+
+    // iterators
+    const_iterator begin() const noexcept { return {this, 0}; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator end() const noexcept { return {this, size()}; }
+    const_iterator cend() const noexcept { return end(); }
+
+    // element access
+    string_view_type operator[](size_type pos) const noexcept { return {row(pos), lengths_[pos]}; }
+    string_view_type at(size_type pos) const
+    {
+      if(pos >= size()) throw std::out_of_range("mp::basic_inplace_string_column::at: 'pos' out of range");
+      return (*this)[pos];
+    }
+    string_view_type front() const noexcept { return (*this)[0]; }
+    string_view_type back() const noexcept { return (*this)[size() - 1]; }
+    value_type get(size_type pos) const { return value_type{(*this)[pos]}; }
+    size_type length(size_type pos) const noexcept { return lengths_[pos]; }
+
+    // raw columns: 'size() * stride' characters and 'size()' lengths
+    const CharT* chars() const noexcept { return chars_.data(); }
+    const length_type* lengths() const noexcept { return lengths_.data(); }
+
+    // capacity
+    bool empty() const noexcept { return lengths_.empty(); }
+    size_type size() const noexcept { return lengths_.size(); }
+    size_type capacity() const noexcept { return lengths_.capacity(); }
+    void reserve(size_type count)
+    {
+      lengths_.reserve(count);
+      chars_.reserve(count * stride + padding);
+    }
+    void shrink_to_fit()
+    {
+      lengths_.shrink_to_fit();
+      chars_.shrink_to_fit();
+    }
+
+    // modifiers
+    void clear() noexcept
+    {
+      lengths_.clear();
+      chars_.resize(padding);
+      std::fill(chars_.begin(), chars_.end(), CharT{});
+    }
+    void push_back(string_view_type s)
+    {
+      check_length(s.size());
+      lengths_.push_back(0);
+      chars_.resize(size() * stride + padding);
+      store(size() - 1, s);
+    }
+    void pop_back() noexcept
+    {
+      lengths_.pop_back();
+      chars_.resize(size() * stride + padding);
+      std::fill_n(chars_.begin() + static_cast<difference_type>(size() * stride), padding, CharT{});
+    }
+    void resize(size_type count)
+    {
+      if(count < size()) {
+        lengths_.resize(count);
+        chars_.resize(count * stride + padding);
+        std::fill_n(chars_.begin() + static_cast<difference_type>(count * stride), padding, CharT{});
+      }
+      else {
+        lengths_.resize(count);
+        chars_.resize(count * stride + padding);
+      }
+    }
+    void set(size_type pos, string_view_type s)
+    {
+      check_length(s.size());
+      store(pos, s);
+    }
+    void swap(basic_inplace_string_column& other) noexcept
+    {
+      chars_.swap(other.chars_);
+      lengths_.swap(other.lengths_);
+    }
+
+    // Bulk scans writing indices of the matching rows, in increasing order, to 'out'.
+    // Rows with 'min <= length <= max'; only the lengths column is read.
+    template<typename OutputIt>
+    OutputIt filter_length(size_type min, size_type max, OutputIt out) const
+    {
+      if(min > max || min > MaxSize) return out;
+      detail::column::scan_sizes(lengths_.data(), size(), static_cast<length_type>(min),
+                                 static_cast<length_type>(std::min(max, MaxSize)),
+                                 [&](size_type i) { *out++ = i; });
+      return out;
+    }
+    // Rows starting with 'prefix'.
+    template<typename OutputIt>
+    OutputIt filter_prefix(string_view_type prefix, OutputIt out) const
+    {
+      const auto m = prefix.size();
+      if(m > MaxSize) return out;
+      if(m == 0) return filter_length(0, MaxSize, out);
+#if defined(MP_INPLACE_STRING_SSE2)
+      if constexpr(std::is_same<Traits, std::char_traits<CharT>>::value && 16 % sizeof(CharT) == 0) {
+        // short prefixes are compared with one unaligned load per row; the slab is padded so it never overruns
+        if(m * sizeof(CharT) <= 16) {
+          alignas(16) CharT needle[16 / sizeof(CharT)] = {};
+          Traits::copy(needle, prefix.data(), m);
+          const auto v = _mm_load_si128(reinterpret_cast<const __m128i*>(needle));
+          const auto expected = detail::low_bits(m * sizeof(CharT));
+          const auto data = chars_.data();
+          for(size_type i = 0, n = size(); i < n; ++i) {
+            const auto r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * stride));
+            const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(r, v)));
+            if((mask & expected) == expected && lengths_[i] >= m) *out++ = i;
+          }
+          return out;
+        }
+      }
+#endif
+      for(size_type i = 0, n = size(); i < n; ++i)
+        if(lengths_[i] >= m && Traits::compare(row(i), prefix.data(), m) == 0) *out++ = i;
+      return out;
+    }
+    // Rows equal to 's'; lengths are scanned first and only the rows of the same length are compared, each with
+    // fixed-size vector loads over the whole zero-padded row.
+    template<typename OutputIt>
+    OutputIt filter_equal(string_view_type s, OutputIt out) const
+    {
+      for_each_equal(s, [&](size_type i) { *out++ = i; });
+      return out;
+    }
+    size_type count_equal(string_view_type s) const
+    {
+      size_type count = 0;
+      for_each_equal(s, [&](size_type) { ++count; });
+      return count;
+    }
+
+  private:
+    // extra zeroed characters after the last row so every row can be read with a full 32-byte vector load
+    static constexpr size_type padding = (32 + sizeof(CharT) - 1) / sizeof(CharT);
+
+    std::vector<CharT> chars_;
+    std::vector<length_type> lengths_;
+
+    CharT* row(size_type pos) noexcept { return chars_.data() + pos * stride; }
+    const CharT* row(size_type pos) const noexcept { return chars_.data() + pos * stride; }
+
+    static void check_length(size_type count)
+    {
+      if(count > MaxSize) throw std::length_error("mp::basic_inplace_string_column: string longer than MaxSize");
+    }
+
+    void store(size_type pos, string_view_type s) noexcept
+    {
+      const auto p = row(pos);
+      Traits::copy(p, s.data(), s.size());
+      std::fill(p + s.size(), p + stride, CharT{});
+      lengths_[pos] = static_cast<length_type>(s.size());
+    }
+
+    template<typename F>
+    void for_each_equal(string_view_type s, F f) const
+    {
+      if(s.size() > MaxSize) return;
+      CharT needle[stride] = {};
+      Traits::copy(needle, s.data(), s.size());
+      const auto data = chars_.data();
+      const auto m = static_cast<length_type>(s.size());
+      detail::column::scan_sizes(lengths_.data(), size(), m, m, [&](size_type i) {
+        if(equal_row(data + i * stride, needle)) f(i);
+      });
+    }
+
+    static bool equal_row(const CharT* lhs, const CharT* rhs) noexcept
+    {
+      if constexpr(std::is_same<Traits, std::char_traits<CharT>>::value)
+        return detail::equal_buffers<stride * sizeof(CharT)>(lhs, rhs);
+      else
+        return Traits::compare(lhs, rhs, stride) == 0;
+    }
+  };
+
+  template<typename CharT, std::size_t MaxSize, typename Traits>
+  bool operator==(const basic_inplace_string_column<CharT, MaxSize, Traits>& lhs,
+                  const basic_inplace_string_column<CharT, MaxSize, Traits>& rhs) noexcept
+  {
+    return lhs.size() == rhs.size() &&
+           std::memcmp(lhs.chars(), rhs.chars(), lhs.size() * MaxSize * sizeof(CharT)) == 0 &&
+           std::equal(lhs.lengths(), lhs.lengths() + lhs.size(), rhs.lengths());
+  }
+  template<typename CharT, std::size_t MaxSize, typename Traits>
+  bool operator!=(const basic_inplace_string_column<CharT, MaxSize, Traits>& lhs,
+                  const basic_inplace_string_column<CharT, MaxSize, Traits>& rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+
+  template<typename CharT, std::size_t MaxSize, typename Traits>
+  void swap(basic_inplace_string_column<CharT, MaxSize, Traits>& lhs,
+            basic_inplace_string_column<CharT, MaxSize, Traits>& rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+  // aliases
+  template<std::size_t MaxSize>
+  using inplace_string_column = basic_inplace_string_column<char, MaxSize>;
+  template<std::size_t MaxSize>
+  using inplace_wstring_column = basic_inplace_string_column<wchar_t, MaxSize>;
+
+}  // namespace mp
@@ -0,0 +1,233 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_string.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+namespace mp {
+
+  // Concurrent hash set storing basic_inplace_string keys inline in open addressing tables. Keys are spread over
+  // 64 independently growing shards. Inside a shard lookups and insertions are lock-free with respect to each
+  // other: a new key claims an empty slot with a single CAS on its tag, is copied in and then published with
+  // a release store of its hash tag. Only growing a shard takes its lock exclusively, so a rehash stalls the
+  // threads using that one shard only. Keys cannot be erased.
+  template<typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+  class basic_inplace_string_concurrent_set {
+    static_assert(is_trivially_relocatable_v<Key>, "Keys have to be trivially relocatable");
+
+  public:
+    using key_type = Key;
+    using value_type = Key;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using key_view_type = std::basic_string_view<typename Key::value_type, typename Key::traits_type>;
+
+    static constexpr size_type shard_count = 64;
+
+    explicit basic_inplace_string_concurrent_set(size_type expected_size = 0, const Hash& hash = Hash{},
+                                                 const KeyEqual& equal = KeyEqual{})
+        : hash_{hash}, equal_{equal}
+    {
+      const auto capacity = capacity_for(expected_size / shard_count + 1);
+      for(auto& s : shards_) s.allocate(capacity);
+    }
+    basic_inplace_string_concurrent_set(const basic_inplace_string_concurrent_set&) = delete;
+    basic_inplace_string_concurrent_set& operator=(const basic_inplace_string_concurrent_set&) = delete;
+
+    // Returns true if 'key' was not in the set yet and was added by this call.
+    bool insert(const key_type& key)
+    {
+      const auto hash = hash_(key);
+      auto& s = shard_for(hash);
+      for(;;) {
+        {
+          std::shared_lock<std::shared_mutex> lock{s.mutex};
+          if(find(s, key, hash)) return false;
+          // reserve room first so concurrent insertions never fill the table up
+          if(s.count.fetch_add(1, std::memory_order_relaxed) < max_load(s.capacity)) {
+            if(claim(s, key, hash)) return true;
+            s.count.fetch_sub(1, std::memory_order_relaxed);  // inserted by another thread in the meantime
+            return false;
+          }
+          s.count.fetch_sub(1, std::memory_order_relaxed);
+        }
+        grow(s);
+      }
+    }
+
+    bool contains(const key_type& key) const
+    {
+      const auto hash = hash_(key);
+      auto& s = shard_for(hash);
+      std::shared_lock<std::shared_mutex> lock{s.mutex};
+      return find(s, key, hash);
+    }
+
+    // heterogeneous versions: text that does not fit in the key type cannot be stored in the set
+    template<typename K, detail::Requires<std::is_convertible<const K&, key_view_type>,
+                                          std::negation<std::is_same<K, key_type>>> = true>
+    bool insert(const K& key)
+    {
+      return insert(key_type{key_view_type{key}});
+    }
+    template<typename K, detail::Requires<std::is_convertible<const K&, key_view_type>,
+                                          std::negation<std::is_same<K, key_type>>> = true>
+    bool contains(const K& key) const
+    {
+      const key_view_type sv{key};
+      return sv.size() <= key_type{}.max_size() && contains(key_type{sv});
+    }
+
+    // approximate while other threads are inserting
+    size_type size() const noexcept
+    {
+      size_type count = 0;
+      for(const auto& s : shards_) count += s.count.load(std::memory_order_relaxed);
+      return count;
+    }
+    bool empty() const noexcept { return size() == 0; }
+
+    hasher hash_function() const { return hash_; }
+    key_equal key_eq() const { return equal_; }
+
+  private:
+    enum : std::uint32_t { tag_empty = 0, tag_busy = 1 };
+
+    struct slot {
+      std::atomic<std::uint32_t> tag;
+      key_type key;
+    };
+
+    struct alignas(64) shard {
+      mutable std::shared_mutex mutex;
+      std::unique_ptr<slot[]> slots;
+      size_type capacity = 0;
+      std::atomic<size_type> count{0};
+
+      void allocate(size_type cap)
+      {
+        slots = std::make_unique<slot[]>(cap);
+        capacity = cap;
+      }
+    };
+
+    shard shards_[shard_count];
+    Hash hash_;
+    KeyEqual equal_;
+
+    static size_type max_load(size_type capacity) noexcept { return capacity / 2; }
+    static size_type capacity_for(size_type count) noexcept
+    {
+      size_type capacity = 16;
+      while(max_load(capacity) < count) capacity *= 2;
+      return capacity;
+    }
+    // never 'tag_empty' or 'tag_busy'
+    static std::uint32_t tag_of(size_type hash) noexcept { return static_cast<std::uint32_t>(hash) | 2u; }
+
+    // the lowest bits of the hash choose the shard and the following ones the position in it
+    shard& shard_for(size_type hash) const noexcept
+    {
+      return const_cast<shard&>(shards_[hash % shard_count]);
+    }
+    static size_type home(const shard& s, size_type hash) noexcept
+    {
+      return hash / shard_count & (s.capacity - 1);
+    }
+
+    // waits until a key being copied by another thread is published
+    static std::uint32_t ready_tag(const slot& sl) noexcept
+    {
+      auto tag = sl.tag.load(std::memory_order_acquire);
+      while(tag == tag_busy) {
+        std::this_thread::yield();
+        tag = sl.tag.load(std::memory_order_acquire);
+      }
+      return tag;
+    }
+
+    bool find(const shard& s, const key_type& key, size_type hash) const
+    {
+      const auto tag = tag_of(hash);
+      for(auto pos = home(s, hash);; pos = (pos + 1) & (s.capacity - 1)) {
+        const auto& sl = s.slots[pos];
+        const auto t = ready_tag(sl);
+        if(t == tag_empty) return false;
+        if(t == tag && equal_(sl.key, key)) return true;
+      }
+    }
+
+    // adds the key to the first empty slot of its probe sequence unless another thread adds it first
+    bool claim(shard& s, const key_type& key, size_type hash)
+    {
+      const auto tag = tag_of(hash);
+      for(auto pos = home(s, hash);; pos = (pos + 1) & (s.capacity - 1)) {
+        auto& sl = s.slots[pos];
+        auto t = sl.tag.load(std::memory_order_acquire);
+        if(t == tag_empty) {
+          if(sl.tag.compare_exchange_strong(t, tag_busy, std::memory_order_acquire)) {
+            sl.key = key;
+            sl.tag.store(tag, std::memory_order_release);
+            return true;
+          }
+        }
+        if(t == tag_busy) t = ready_tag(sl);
+        if(t == tag && equal_(sl.key, key)) return false;
+      }
+    }
+
+    void grow(shard& s)
+    {
+      std::unique_lock<std::shared_mutex> lock{s.mutex};
+      if(s.count.load(std::memory_order_relaxed) < max_load(s.capacity)) return;  // already grown by another thread
+      const auto old = std::move(s.slots);
+      const auto old_capacity = s.capacity;
+      s.allocate(old_capacity * 2);
+      for(size_type i = 0; i < old_capacity; ++i) {
+        const auto tag = old[i].tag.load(std::memory_order_relaxed);
+        if(tag == tag_empty) continue;
+        const auto hash = hash_(old[i].key);
+        auto pos = home(s, hash);
+        while(s.slots[pos].tag.load(std::memory_order_relaxed) != tag_empty) pos = (pos + 1) & (s.capacity - 1);
+        s.slots[pos].key = old[i].key;
+        s.slots[pos].tag.store(tag, std::memory_order_relaxed);
+      }
+    }
+  };
+
+  // aliases
+  template<std::size_t MaxSize>
+  using inplace_string_concurrent_set = basic_inplace_string_concurrent_set<inplace_string<MaxSize>>;
+
+}  // namespace mp
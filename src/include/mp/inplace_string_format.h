@@ -0,0 +1,169 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_string.h>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#if __has_include(<format>)
+#include <format>
+#endif
+
+// std::formatter for basic_inplace_string and mp::format_to() are provided if the standard library has <format>
+#if defined(__cpp_lib_format)
+#define MP_INPLACE_STRING_FORMAT 1
+#endif
+
+namespace mp {
+
+  // Output iterator appending characters to a basic_inplace_string (std::back_insert_iterator without the
+  // std::string interface requirements). Characters that do not fit are handled according to the overflow policy
+  // of the string; once one was dropped all the following ones are dropped too and with 'truncate_utf8' policy
+  // an incomplete code point is removed from the end of the string.
+  template<typename Str>
+  class inplace_string_append_iterator {
+  public:
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+    using container_type = Str;
+
+    explicit inplace_string_append_iterator(Str& str) noexcept : str_{&str} {}
+
+    inplace_string_append_iterator& operator=(typename Str::value_type c)
+    {
+      if(!truncated_ && !str_->try_push_back(c)) overflow(c);
+      return *this;
+    }
+    inplace_string_append_iterator& operator*() noexcept { return *this; }
+    inplace_string_append_iterator& operator++() noexcept { return *this; }
+    inplace_string_append_iterator operator++(int) noexcept { return *this; }
+
+    // true if some of the characters were dropped
+    bool truncated() const noexcept { return truncated_; }
+
+  private:
+    using policy = typename detail::inplace_string_policy<Str>::type;
+
+    Str* str_;
+    bool truncated_ = false;
+
+    void overflow(typename Str::value_type c)
+    {
+      if constexpr(policy::overflow == inplace_string_overflow::throw_exception)
+        throw std::length_error("mp::basic_inplace_string: size() > max_size()");
+      assert(policy::overflow != inplace_string_overflow::unchecked);
+      truncated_ = true;
+      if constexpr(policy::overflow == inplace_string_overflow::truncate_utf8) {
+        if(detail::is_continuation(c)) str_->resize(detail::complete_code_points(str_->data(), str_->size()));
+      }
+    }
+  };
+
+  template<typename Str>
+  inplace_string_append_iterator<Str> appender(Str& str) noexcept
+  {
+    return inplace_string_append_iterator<Str>{str};
+  }
+
+#if defined(MP_INPLACE_STRING_FORMAT)
+
+  namespace detail {
+
+    // Appends the result of 'format(first, n)' which writes at most 'n' characters starting at 'first' directly to
+    // the free part of the storage and returns the number of the characters of the whole formatted text.
+    template<typename CharT, std::size_t MaxSize, typename Traits, typename Policy, typename Format>
+    inplace_string_result format_append(basic_inplace_string<CharT, MaxSize, Traits, Policy>& str, Format format)
+    {
+      const std::size_t sz = str.size();
+      const auto first = str.data() + sz;
+      const auto available = str.max_size() - sz;
+      const auto required = static_cast<std::size_t>(format(first, available));
+      const auto written = std::min(required, available);
+      auto count = written;
+      if(written < required) {
+        if constexpr(Policy::overflow == inplace_string_overflow::throw_exception ||
+                     Policy::overflow == inplace_string_overflow::unchecked)
+          count = 0;
+        else if constexpr(Policy::overflow == inplace_string_overflow::truncate_utf8)
+          count = complete_code_points(first, written);
+      }
+      if constexpr(Policy::zero_padded_tail) Traits::assign(first + count, written - count, CharT{});
+      inplace_string_access::size(str, sz + count);
+      if constexpr(Policy::overflow == inplace_string_overflow::throw_exception) {
+        if(count < required) throw std::length_error("mp::basic_inplace_string: size() > max_size()");
+      }
+      assert(Policy::overflow != inplace_string_overflow::unchecked || count == required);
+      return {count, count == required ? std::errc{} : std::errc::value_too_large};
+    }
+
+  }  // namespace detail
+
+  // Appends the formatted text straight to the storage of the string (no intermediate buffer or heap allocation).
+  // What does not fit is handled according to the overflow policy; with the truncating ones the count of
+  // the result is the number of the appended characters.
+  template<std::size_t MaxSize, typename Policy, typename... Args>
+  inplace_string_result format_to(basic_inplace_string<char, MaxSize, std::char_traits<char>, Policy>& str,
+                                  std::format_string<Args...> fmt, Args&&... args)
+  {
+    return detail::format_append(str, [&](char* first, std::size_t n) {
+      return std::format_to_n(first, static_cast<std::ptrdiff_t>(n), fmt, std::forward<Args>(args)...).size;
+    });
+  }
+  template<std::size_t MaxSize, typename Policy, typename... Args>
+  inplace_string_result format_to(basic_inplace_string<wchar_t, MaxSize, std::char_traits<wchar_t>, Policy>& str,
+                                  std::wformat_string<Args...> fmt, Args&&... args)
+  {
+    return detail::format_append(str, [&](wchar_t* first, std::size_t n) {
+      return std::format_to_n(first, static_cast<std::ptrdiff_t>(n), fmt, std::forward<Args>(args)...).size;
+    });
+  }
+
+#endif  // MP_INPLACE_STRING_FORMAT
+
+}  // namespace mp
+
+#if defined(MP_INPLACE_STRING_FORMAT)
+
+// formatted as its std::basic_string_view with all the string format specifications
+template<typename CharT, std::size_t MaxSize, typename Policy>
+struct std::formatter<mp::basic_inplace_string<CharT, MaxSize, std::char_traits<CharT>, Policy>, CharT>
+    : std::formatter<std::basic_string_view<CharT>, CharT> {
+  template<typename FormatContext>
+  auto format(const mp::basic_inplace_string<CharT, MaxSize, std::char_traits<CharT>, Policy>& str,
+              FormatContext& ctx) const
+  {
+    return std::formatter<std::basic_string_view<CharT>, CharT>::format(std::basic_string_view<CharT>{str}, ctx);
+  }
+};
+
+#endif  // MP_INPLACE_STRING_FORMAT
@@ -0,0 +1,551 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_string.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace mp {
+
+  namespace detail {
+
+    // control bytes of the open addressing table: 7 lowest bits of a hash for full slots
+    using ctrl_t = std::int8_t;
+    constexpr ctrl_t ctrl_empty = -128;
+    constexpr ctrl_t ctrl_deleted = -2;
+
+    // metadata of 16 consecutive slots scanned at once
+    struct ctrl_group {
+      static constexpr std::size_t width = 16;
+
+#if defined(MP_INPLACE_STRING_SSE2)
+      __m128i ctrl;
+
+      explicit ctrl_group(const ctrl_t* p) noexcept : ctrl{_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))} {}
+      std::uint32_t match(ctrl_t h2) const noexcept
+      {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+      }
+      std::uint32_t match_empty() const noexcept { return match(ctrl_empty); }
+      std::uint32_t match_empty_or_deleted() const noexcept
+      {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl));
+      }
+#else
+      const ctrl_t* ctrl;
+
+      explicit ctrl_group(const ctrl_t* p) noexcept : ctrl{p} {}
+      std::uint32_t match(ctrl_t h2) const noexcept
+      {
+        std::uint32_t mask = 0;
+        for(std::size_t i = 0; i < width; ++i) mask |= std::uint32_t{ctrl[i] == h2} << i;
+        return mask;
+      }
+      std::uint32_t match_empty() const noexcept { return match(ctrl_empty); }
+      std::uint32_t match_empty_or_deleted() const noexcept
+      {
+        std::uint32_t mask = 0;
+        for(std::size_t i = 0; i < width; ++i) mask |= std::uint32_t{ctrl[i] < 0} << i;
+        return mask;
+      }
+#endif
+    };
+
+    // all slots empty; used by tables without allocated storage so lookups do not need to check for it
+    alignas(16) inline constexpr ctrl_t empty_ctrl_group[ctrl_group::width] = {
+        ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+        ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty};
+
+  }  // namespace detail
+
+  // Open addressing (Swiss table style) hash map storing basic_inplace_string keys together with the mapped values
+  // directly in one slot array. Lookups scan 16 control bytes at once and, as keys are trivially copyable and
+  // fixed-size, no node allocations are needed. Pointers, references and iterators are invalidated on rehash.
+  template<typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+  class basic_inplace_string_map {
+    static_assert(is_trivially_relocatable_v<Key>, "Keys have to be trivially relocatable");
+
+  public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+    using key_view_type = std::basic_string_view<typename Key::value_type, typename Key::traits_type>;
+
+  private:
+    using ctrl_t = detail::ctrl_t;
+    using group = detail::ctrl_group;
+
+    struct slot_type {
+      alignas(value_type) unsigned char storage[sizeof(value_type)];
+      value_type* get() noexcept { return std::launder(reinterpret_cast<value_type*>(storage)); }
+      const value_type* get() const noexcept { return std::launder(reinterpret_cast<const value_type*>(storage)); }
+    };
+
+    // slots can be moved around with memcpy on rehash
+    static constexpr bool trivially_relocatable =
+        std::is_trivially_copy_constructible<T>::value && std::is_trivially_destructible<T>::value;
+
+    template<bool Const>
+    class iterator_impl {
+      friend class basic_inplace_string_map;
+      using ctrl_ptr = const ctrl_t*;
+      using slot_ptr = std::conditional_t<Const, const slot_type*, slot_type*>;
+      ctrl_ptr ctrl_ = nullptr;
+      ctrl_ptr end_ = nullptr;
+      slot_ptr slot_ = nullptr;
+
+      iterator_impl(ctrl_ptr ctrl, ctrl_ptr end, slot_ptr slot) noexcept : ctrl_{ctrl}, end_{end}, slot_{slot}
+      {
+        skip_empty();
+      }
+      void skip_empty() noexcept
+      {
+        while(ctrl_ != end_ && *ctrl_ < 0) {
+          ++ctrl_;
+          ++slot_;
+        }
+      }
+
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = basic_inplace_string_map::value_type;
+      using difference_type = basic_inplace_string_map::difference_type;
+      using reference = std::conditional_t<Const, const value_type&, value_type&>;
+      using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+      iterator_impl() = default;
+      template<bool C = Const, std::enable_if_t<C, bool> = true>
+      iterator_impl(const iterator_impl<false>& other) noexcept
+          : ctrl_{other.ctrl_}, end_{other.end_}, slot_{other.slot_}
+      {
+      }
+
+      reference operator*() const noexcept { return *slot_->get(); }
+      pointer operator->() const noexcept { return slot_->get(); }
+      iterator_impl& operator++() noexcept
+      {
+        ++ctrl_;
+        ++slot_;
+        skip_empty();
+        return *this;
+      }
+      iterator_impl operator++(int) noexcept
+      {
+        auto tmp = *this;
+        ++*this;
+        return tmp;
+      }
+      friend bool operator==(const iterator_impl& lhs, const iterator_impl& rhs) noexcept
+      {
+        return lhs.ctrl_ == rhs.ctrl_;
+      }
+      friend bool operator!=(const iterator_impl& lhs, const iterator_impl& rhs) noexcept { return !(lhs == rhs); }
+    };
+
+  public:
+    using iterator = iterator_impl<false>;
+    using const_iterator = iterator_impl<true>;
+
+    // constructors
+    basic_inplace_string_map() = default;
+    explicit basic_inplace_string_map(size_type bucket_count, const Hash& hash = Hash{},
+                                      const KeyEqual& equal = KeyEqual{})
+        : hash_{hash}, equal_{equal}
+    {
+      reserve(bucket_count);
+    }
+    basic_inplace_string_map(std::initializer_list<value_type> ilist)
+    {
+      reserve(ilist.size());
+      for(const auto& v : ilist) insert(v);
+    }
+    basic_inplace_string_map(const basic_inplace_string_map& other) : hash_{other.hash_}, equal_{other.equal_}
+    {
+      reserve(other.size());
+      for(const auto& v : other) insert_unique(v.first, v);
+    }
+    basic_inplace_string_map(basic_inplace_string_map&& other) noexcept
+        : ctrl_{std::exchange(other.ctrl_, empty_ctrl())},
+          slots_{std::exchange(other.slots_, nullptr)},
+          capacity_{std::exchange(other.capacity_, 0)},
+          size_{std::exchange(other.size_, 0)},
+          growth_left_{std::exchange(other.growth_left_, 0)},
+          hash_{std::move(other.hash_)},
+          equal_{std::move(other.equal_)}
+    {
+    }
+    ~basic_inplace_string_map() { destroy(); }
+
+    // assignment
+    basic_inplace_string_map& operator=(const basic_inplace_string_map& other)
+    {
+      if(this != &other) {
+        basic_inplace_string_map tmp{other};
+        swap(tmp);
+      }
+      return *this;
+    }
+    basic_inplace_string_map& operator=(basic_inplace_string_map&& other) noexcept
+    {
+      basic_inplace_string_map tmp{std::move(other)};
+      swap(tmp);
+      return *this;
+    }
+
+    // iterators
+    iterator begin() noexcept { return {ctrl_, ctrl_ + capacity_, slots_}; }
+    const_iterator begin() const noexcept { return {ctrl_, ctrl_ + capacity_, slots_}; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    iterator end() noexcept { return {ctrl_ + capacity_, ctrl_ + capacity_, slots_ + capacity_}; }
+    const_iterator end() const noexcept { return {ctrl_ + capacity_, ctrl_ + capacity_, slots_ + capacity_}; }
+    const_iterator cend() const noexcept { return end(); }
+
+    // capacity
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type max_size() const noexcept { return std::numeric_limits<difference_type>::max() / sizeof(slot_type); }
+    size_type capacity() const noexcept { return capacity_; }
+    float load_factor() const noexcept { return capacity_ ? static_cast<float>(size_) / capacity_ : 0.0f; }
+    float max_load_factor() const noexcept { return 7.0f / 8.0f; }
+
+    // modifiers
+    void clear() noexcept
+    {
+      if(capacity_ == 0) return;
+      destroy_slots();
+      std::memset(ctrl_, detail::ctrl_empty, capacity_ + group::width);
+      size_ = 0;
+      growth_left_ = max_load(capacity_);
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+    std::pair<iterator, bool> insert(value_type&& value) { return try_emplace(value.first, std::move(value.second)); }
+    template<class InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+      for(; first != last; ++first) insert(*first);
+    }
+    void insert(std::initializer_list<value_type> ilist) { insert(ilist.begin(), ilist.end()); }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+    {
+      const auto hash = hash_(key);
+      if(const auto index = find_index(key, hash); index != npos) return {iterator_at(index), false};
+      const auto index = prepare_insert(hash);
+      ::new(static_cast<void*>(slots_[index].storage))
+          value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                     std::forward_as_tuple(std::forward<Args>(args)...));
+      set_ctrl(index, h2(hash));
+      ++size_;
+      return {iterator_at(index), true};
+    }
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(const key_type& key, Args&&... args)
+    {
+      return try_emplace(key, std::forward<Args>(args)...);
+    }
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj)
+    {
+      auto result = try_emplace(key, std::forward<M>(obj));
+      if(!result.second) result.first->second = std::forward<M>(obj);
+      return result;
+    }
+
+    iterator erase(const_iterator pos) noexcept
+    {
+      const auto index = static_cast<size_type>(pos.ctrl_ - ctrl_);
+      erase_at(index);
+      return iterator_at(index + 1);
+    }
+    size_type erase(const key_type& key) noexcept(noexcept(std::declval<const Hash&>()(key)))
+    {
+      const auto index = find_index(key, hash_(key));
+      if(index == npos) return 0;
+      erase_at(index);
+      return 1;
+    }
+
+    void swap(basic_inplace_string_map& other) noexcept
+    {
+      using std::swap;
+      swap(ctrl_, other.ctrl_);
+      swap(slots_, other.slots_);
+      swap(capacity_, other.capacity_);
+      swap(size_, other.size_);
+      swap(growth_left_, other.growth_left_);
+      swap(hash_, other.hash_);
+      swap(equal_, other.equal_);
+    }
+
+    // lookup
+    T& operator[](const key_type& key) { return try_emplace(key).first->second; }
+    T& at(const key_type& key)
+    {
+      const auto index = find_index(key, hash_(key));
+      if(index == npos) throw std::out_of_range("mp::basic_inplace_string_map::at: key not found");
+      return slots_[index].get()->second;
+    }
+    const T& at(const key_type& key) const { return const_cast<basic_inplace_string_map&>(*this).at(key); }
+    iterator find(const key_type& key)
+    {
+      const auto index = find_index(key, hash_(key));
+      return index == npos ? end() : iterator_at(index);
+    }
+    const_iterator find(const key_type& key) const { return const_cast<basic_inplace_string_map&>(*this).find(key); }
+    size_type count(const key_type& key) const { return find_index(key, hash_(key)) != npos; }
+    bool contains(const key_type& key) const { return count(key) != 0; }
+
+    // heterogeneous lookup: text that does not fit in the key type cannot be stored in the map
+    template<typename K, detail::Requires<std::is_convertible<const K&, key_view_type>,
+                                          std::negation<std::is_same<K, key_type>>> = true>
+    iterator find(const K& key)
+    {
+      const key_view_type sv{key};
+      if(sv.size() > Key{}.max_size()) return end();
+      return find(key_type{sv});
+    }
+    template<typename K, detail::Requires<std::is_convertible<const K&, key_view_type>,
+                                          std::negation<std::is_same<K, key_type>>> = true>
+    const_iterator find(const K& key) const
+    {
+      return const_cast<basic_inplace_string_map&>(*this).find(key);
+    }
+    template<typename K, detail::Requires<std::is_convertible<const K&, key_view_type>,
+                                          std::negation<std::is_same<K, key_type>>> = true>
+    size_type count(const K& key) const
+    {
+      return find(key) != end();
+    }
+    template<typename K, detail::Requires<std::is_convertible<const K&, key_view_type>,
+                                          std::negation<std::is_same<K, key_type>>> = true>
+    bool contains(const K& key) const
+    {
+      return count(key) != 0;
+    }
+
+    // hash policy
+    void reserve(size_type count)
+    {
+      if(count > max_load(capacity_)) rehash(capacity_for(count));
+    }
+    void rehash(size_type count)
+    {
+      count = std::max(count, capacity_for(size_));
+      if(count == 0) {
+        if(size_ == 0) {
+          destroy();
+          reset();
+        }
+        return;
+      }
+      resize(capacity_for_buckets(count));
+    }
+
+    hasher hash_function() const { return hash_; }
+    key_equal key_eq() const { return equal_; }
+
+  private:
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    ctrl_t* ctrl_ = empty_ctrl();
+    slot_type* slots_ = nullptr;
+    size_type capacity_ = 0;
+    size_type size_ = 0;
+    size_type growth_left_ = 0;
+    Hash hash_;
+    KeyEqual equal_;
+
+    static ctrl_t* empty_ctrl() noexcept { return const_cast<ctrl_t*>(detail::empty_ctrl_group); }
+    static size_type h1(size_type hash) noexcept { return hash >> 7; }
+    static ctrl_t h2(size_type hash) noexcept { return static_cast<ctrl_t>(hash & 0x7f); }
+    static size_type max_load(size_type capacity) noexcept { return capacity - capacity / 8; }
+    static size_type capacity_for(size_type count) noexcept
+    {
+      return count ? capacity_for_buckets(count + (count + 6) / 7) : 0;
+    }
+    static size_type capacity_for_buckets(size_type count) noexcept
+    {
+      size_type capacity = group::width;
+      while(capacity < count) capacity *= 2;
+      return capacity;
+    }
+
+    iterator iterator_at(size_type index) noexcept { return {ctrl_ + index, ctrl_ + capacity_, slots_ + index}; }
+
+    // ctrl_ holds 'capacity_' bytes followed by a copy of the first group so each group can be loaded unaligned
+    void set_ctrl(size_type index, ctrl_t value) noexcept
+    {
+      ctrl_[index] = value;
+      if(index < group::width) ctrl_[capacity_ + index] = value;
+    }
+
+    // groups are visited with a triangular sequence which covers the whole power of 2 sized table
+    size_type find_index(const key_type& key, size_type hash) const
+    {
+      const size_type mask = capacity_ ? capacity_ - 1 : 0;
+      size_type pos = h1(hash) & mask;
+      for(size_type step = group::width;; step += group::width) {
+        const group g{ctrl_ + pos};
+        for(auto match = g.match(h2(hash)); match; match &= match - 1) {
+          const auto index = (pos + detail::countr_zero(match)) & mask;
+          if(equal_(slots_[index].get()->first, key)) return index;
+        }
+        if(g.match_empty()) return npos;
+        pos = (pos + step) & mask;
+      }
+    }
+
+    size_type find_free(size_type hash) const noexcept
+    {
+      const size_type mask = capacity_ - 1;
+      size_type pos = h1(hash) & mask;
+      for(size_type step = group::width;; step += group::width) {
+        const group g{ctrl_ + pos};
+        if(const auto free = g.match_empty_or_deleted()) return (pos + detail::countr_zero(free)) & mask;
+        pos = (pos + step) & mask;
+      }
+    }
+
+    size_type prepare_insert(size_type hash)
+    {
+      auto index = capacity_ ? find_free(hash) : npos;
+      if(growth_left_ == 0 && (index == npos || ctrl_[index] != detail::ctrl_deleted)) {
+        // drop tombstones when they occupy most of the table, otherwise grow it
+        resize(size_ * 2 + size_ / 2 < capacity_ ? std::max<size_type>(capacity_, group::width)
+                                                     : std::max<size_type>(capacity_ * 2, group::width));
+        index = find_free(hash);
+      }
+      if(ctrl_[index] == detail::ctrl_empty) --growth_left_;
+      return index;
+    }
+
+    void erase_at(size_type index) noexcept
+    {
+      slots_[index].get()->~value_type();
+      set_ctrl(index, detail::ctrl_deleted);
+      --size_;
+    }
+
+    void resize(size_type new_capacity)
+    {
+      auto old_ctrl = ctrl_;
+      auto old_slots = slots_;
+      const auto old_capacity = capacity_;
+
+      auto ctrl_buffer = std::make_unique<ctrl_t[]>(new_capacity + group::width);
+      slots_ = std::allocator<slot_type>{}.allocate(new_capacity);
+      ctrl_ = ctrl_buffer.release();
+      capacity_ = new_capacity;
+      std::memset(ctrl_, detail::ctrl_empty, capacity_ + group::width);
+      growth_left_ = max_load(capacity_) - size_;
+
+      for(size_type i = 0; i < old_capacity; ++i) {
+        if(old_ctrl[i] < 0) continue;
+        auto& old = *old_slots[i].get();
+        const auto hash = hash_(old.first);
+        const auto index = find_free(hash);
+        set_ctrl(index, h2(hash));
+        if constexpr(trivially_relocatable) {
+          std::memcpy(&slots_[index], &old_slots[i], sizeof(slot_type));
+        }
+        else {
+          ::new(static_cast<void*>(slots_[index].storage)) value_type(std::move(old));
+          old.~value_type();
+        }
+      }
+      if(old_capacity) deallocate(old_ctrl, old_slots, old_capacity);
+    }
+
+    template<typename V>
+    void insert_unique(const key_type& key, V&& value)
+    {
+      const auto hash = hash_(key);
+      const auto index = prepare_insert(hash);
+      ::new(static_cast<void*>(slots_[index].storage)) value_type(std::forward<V>(value));
+      set_ctrl(index, h2(hash));
+      ++size_;
+    }
+
+    void destroy_slots() noexcept
+    {
+      if constexpr(!std::is_trivially_destructible<value_type>::value)
+        for(size_type i = 0; i < capacity_; ++i)
+          if(ctrl_[i] >= 0) slots_[i].get()->~value_type();
+    }
+
+    static void deallocate(ctrl_t* ctrl, slot_type* slots, size_type capacity) noexcept
+    {
+      delete[] ctrl;
+      std::allocator<slot_type>{}.deallocate(slots, capacity);
+    }
+
+    void destroy() noexcept
+    {
+      if(capacity_ == 0) return;
+      destroy_slots();
+      deallocate(ctrl_, slots_, capacity_);
+    }
+
+    void reset() noexcept
+    {
+      ctrl_ = empty_ctrl();
+      slots_ = nullptr;
+      capacity_ = size_ = growth_left_ = 0;
+    }
+  };
+
+  template<typename Key, typename T, typename Hash, typename KeyEqual>
+  void swap(basic_inplace_string_map<Key, T, Hash, KeyEqual>& lhs,
+            basic_inplace_string_map<Key, T, Hash, KeyEqual>& rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+  // aliases
+  template<std::size_t MaxSize, typename T>
+  using inplace_string_map = basic_inplace_string_map<inplace_string<MaxSize>, T>;
+
+}  // namespace mp
@@ -0,0 +1,160 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_string.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace mp {
+
+  // Interning dictionary assigning dense 32-bit ids (0, 1, 2, ...) to distinct strings. The id to string lookup is
+  // an array index and string to id lookups never lock: both the strings and the open addressing index are
+  // allocated once for a fixed capacity and entries are only ever published (with release stores), never moved or
+  // removed. Insertions of new strings are serialized with a mutex.
+  template<typename Str, typename Hash = std::hash<Str>>
+  class basic_inplace_string_pool {
+    static_assert(is_trivially_relocatable_v<Str>, "Strings have to be trivially relocatable");
+
+  public:
+    using value_type = Str;
+    using id_type = std::uint32_t;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using string_view_type = std::basic_string_view<typename Str::value_type, typename Str::traits_type>;
+
+    static constexpr id_type npos = static_cast<id_type>(-1);
+
+    explicit basic_inplace_string_pool(size_type capacity, const Hash& hash = Hash{})
+        : strings_{std::make_unique<Str[]>(checked(capacity))},
+          slots_{std::make_unique<std::atomic<id_type>[]>(slots_for(capacity))},
+          capacity_{capacity},
+          mask_{slots_for(capacity) - 1},
+          hash_{hash}
+    {
+    }
+    basic_inplace_string_pool(const basic_inplace_string_pool&) = delete;
+    basic_inplace_string_pool& operator=(const basic_inplace_string_pool&) = delete;
+
+    // Returns the id of 'str', adding it to the pool first if needed.
+    // Throws std::length_error when a new string does not fit in the capacity of the pool.
+    id_type intern(const Str& str)
+    {
+      const auto hash = hash_(str);
+      if(const auto id = find(str, hash); id != npos) return id;
+
+      std::lock_guard<std::mutex> lock{mutex_};
+      auto pos = hash & mask_;
+      for(;; pos = (pos + 1) & mask_) {
+        const auto slot = slots_[pos].load(std::memory_order_acquire);
+        if(slot == 0) break;
+        if(strings_[slot - 1] == str) return slot - 1;  // added by another writer in the meantime
+      }
+      const auto id = size_.load(std::memory_order_relaxed);
+      if(id == capacity_) throw std::length_error("mp::basic_inplace_string_pool: capacity exceeded");
+      strings_[id] = str;
+      slots_[pos].store(id + 1, std::memory_order_release);
+      size_.store(id + 1, std::memory_order_release);
+      return id;
+    }
+    template<typename K, detail::Requires<std::is_convertible<const K&, string_view_type>,
+                                          std::negation<std::is_same<K, Str>>> = true>
+    id_type intern(const K& str)
+    {
+      return intern(Str{string_view_type{str}});
+    }
+
+    // Returns the id of 'str' or npos if it is not in the pool. Never blocks.
+    id_type find(const Str& str) const noexcept(noexcept(std::declval<const Hash&>()(str)))
+    {
+      return find(str, hash_(str));
+    }
+    template<typename K, detail::Requires<std::is_convertible<const K&, string_view_type>,
+                                          std::negation<std::is_same<K, Str>>> = true>
+    id_type find(const K& str) const
+    {
+      const string_view_type sv{str};
+      return sv.size() > Str{}.max_size() ? npos : find(Str{sv});
+    }
+    template<typename K>
+    bool contains(const K& str) const
+    {
+      return find(str) != npos;
+    }
+
+    // id to string; 'id' has to be obtained from this pool
+    const Str& operator[](id_type id) const noexcept { return strings_[id]; }
+    const Str& at(id_type id) const
+    {
+      if(id >= size()) throw std::out_of_range("mp::basic_inplace_string_pool::at: unknown id");
+      return strings_[id];
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+    size_type size() const noexcept { return size_.load(std::memory_order_acquire); }
+    size_type capacity() const noexcept { return capacity_; }
+
+  private:
+    // slots store 'id + 1' (0 marks an empty slot); the index is kept at most half full
+    std::unique_ptr<Str[]> strings_;
+    std::unique_ptr<std::atomic<id_type>[]> slots_;
+    size_type capacity_;
+    size_type mask_;
+    std::atomic<id_type> size_{0};
+    std::mutex mutex_;
+    Hash hash_;
+
+    static size_type checked(size_type capacity)
+    {
+      if(capacity >= npos) throw std::length_error("mp::basic_inplace_string_pool: capacity too big");
+      return capacity;
+    }
+    static size_type slots_for(size_type capacity) noexcept
+    {
+      size_type count = 16;
+      while(count < capacity * 2) count *= 2;
+      return count;
+    }
+
+    id_type find(const Str& str, size_type hash) const noexcept
+    {
+      for(auto pos = hash & mask_;; pos = (pos + 1) & mask_) {
+        const auto slot = slots_[pos].load(std::memory_order_acquire);
+        if(slot == 0) return npos;
+        if(strings_[slot - 1] == str) return slot - 1;
+      }
+    }
+  };
+
+  // aliases
+  template<std::size_t MaxSize>
+  using inplace_string_pool = basic_inplace_string_pool<inplace_string<MaxSize>>;
+
+}  // namespace mp
@@ -0,0 +1,214 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <mp/inplace_string.h>
+#include <algorithm>
+#include <cstddef>
+#include <ios>
+#include <istream>
+#include <locale>
+#include <ostream>
+#include <streambuf>
+
+namespace mp {
+
+  // Extracts a whitespace separated word like the std::basic_string overload does but reads the characters
+  // straight into the storage of the string. Extraction stops after width() or max_size() characters; the rest of
+  // the word stays in the stream.
+  template<typename CharT, std::size_t MaxSize, typename Traits, typename Policy>
+  std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is,
+                                                basic_inplace_string<CharT, MaxSize, Traits, Policy>& str)
+  {
+    const typename std::basic_istream<CharT, Traits>::sentry sentry{is};
+    if(!sentry) return is;
+    const std::streamsize width = is.width();
+    const std::size_t n =
+        width > 0 ? std::min(static_cast<std::size_t>(width), std::size_t{MaxSize}) : std::size_t{MaxSize};
+    const auto& ctype = std::use_facet<std::ctype<CharT>>(is.getloc());
+    const auto buf = is.rdbuf();
+    str.clear();
+    const auto out = str.data();
+    std::size_t count = 0;
+    std::ios_base::iostate state = std::ios_base::goodbit;
+    try {
+      for(auto c = buf->sgetc();; c = buf->snextc()) {
+        if(Traits::eq_int_type(c, Traits::eof())) {
+          state |= std::ios_base::eofbit;
+          break;
+        }
+        if(count == n || ctype.is(std::ctype_base::space, Traits::to_char_type(c))) break;
+        out[count++] = Traits::to_char_type(c);
+      }
+    }
+    catch(...) {
+      detail::inplace_string_access::size(str, count);
+      if(is.exceptions() & std::ios_base::badbit) throw;
+      is.setstate(std::ios_base::badbit);
+      return is;
+    }
+    detail::inplace_string_access::size(str, count);
+    is.width(0);
+    if(count == 0) state |= std::ios_base::failbit;
+    is.setstate(state);
+    return is;
+  }
+
+  // Reads a line like std::getline() does but straight into the storage of the string. A line longer than
+  // max_size() sets failbit and leaves the rest of it in the stream. Call it unqualified (found with ADL) or as
+  // mp::getline(); std::getline() accepts only std::basic_string.
+  // basic_istream::getline() has the same rules for stopping and failing and is the fast path of the standard
+  // library (it searches the get area for the delimiter); its null character lands on the storage right after
+  // max_size() characters (the terminator or the size) which is overwritten with the size right away.
+  template<typename CharT, std::size_t MaxSize, typename Traits, typename Policy>
+  std::basic_istream<CharT, Traits>& getline(std::basic_istream<CharT, Traits>& is,
+                                             basic_inplace_string<CharT, MaxSize, Traits, Policy>& str, CharT delim)
+  {
+    if(!is.good()) {
+      is.setstate(std::ios_base::failbit);
+      return is;
+    }
+    str.clear();
+    // the delimiter was extracted only if the line ended without any error
+    const auto set_size = [&] {
+      const auto extracted = static_cast<std::size_t>(is.gcount());
+      detail::inplace_string_access::size(str, is.good() ? extracted - 1 : extracted);
+    };
+    try {
+      is.getline(str.data(), static_cast<std::streamsize>(MaxSize + 1), delim);
+    }
+    catch(...) {
+      set_size();
+      throw;
+    }
+    set_size();
+    return is;
+  }
+
+  template<typename CharT, std::size_t MaxSize, typename Traits, typename Policy>
+  std::basic_istream<CharT, Traits>& getline(std::basic_istream<CharT, Traits>& is,
+                                             basic_inplace_string<CharT, MaxSize, Traits, Policy>& str)
+  {
+    return mp::getline(is, str, is.widen('\n'));
+  }
+
+  // Stream buffer appending to a basic_inplace_string. Its put area is the free part of the storage of the string
+  // so the characters are written in place; the size of the string is updated on sync() (also done by
+  // std::flush), str() and destruction. A character that does not fit makes the stream bad for 'throw_exception'
+  // and 'unchecked' overflow policies; the truncating ones drop it and all the following characters (with
+  // 'truncate_utf8' an incomplete code point is removed from the end of the string).
+  template<typename Str>
+  class basic_inplace_stringbuf : public std::basic_streambuf<typename Str::value_type, typename Str::traits_type> {
+    using base = std::basic_streambuf<typename Str::value_type, typename Str::traits_type>;
+    using policy = typename detail::inplace_string_policy<Str>::type;
+
+  public:
+    using char_type = typename base::char_type;
+    using traits_type = typename base::traits_type;
+    using int_type = typename base::int_type;
+    using pos_type = typename base::pos_type;
+    using off_type = typename base::off_type;
+    using string_type = Str;
+
+    explicit basic_inplace_stringbuf(Str& str) : str_{&str}
+    {
+      this->setp(str.data() + str.size(), str.data() + str.max_size());
+    }
+    basic_inplace_stringbuf(const basic_inplace_stringbuf&) = delete;
+    basic_inplace_stringbuf& operator=(const basic_inplace_stringbuf&) = delete;
+    ~basic_inplace_stringbuf() override { commit(); }
+
+    Str& str() noexcept
+    {
+      commit();
+      return *str_;
+    }
+
+    // true if some of the characters were dropped
+    bool truncated() const noexcept { return truncated_; }
+
+  protected:
+    int sync() override
+    {
+      commit();
+      return 0;
+    }
+
+    int_type overflow(int_type c) override
+    {
+      if(traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+      if constexpr(policy::overflow == inplace_string_overflow::throw_exception ||
+                   policy::overflow == inplace_string_overflow::unchecked)
+        return traits_type::eof();
+      else {
+        if(!truncated_) {
+          truncated_ = true;
+          if constexpr(policy::overflow == inplace_string_overflow::truncate_utf8) {
+            if(detail::is_continuation(traits_type::to_char_type(c))) {
+              const auto sz = static_cast<std::size_t>(this->pptr() - str_->data());
+              const auto keep = detail::complete_code_points(str_->data(), sz);
+              if constexpr(policy::zero_padded_tail) traits_type::assign(str_->data() + keep, sz - keep, char_type{});
+              this->pbump(-static_cast<int>(sz - keep));
+            }
+          }
+          commit();
+          this->setp(this->pptr(), this->pptr());
+        }
+        return traits_type::not_eof(c);
+      }
+    }
+
+  private:
+    Str* str_;
+    bool truncated_ = false;
+
+    void commit() noexcept
+    {
+      detail::inplace_string_access::size(*str_, static_cast<std::size_t>(this->pptr() - str_->data()));
+    }
+  };
+
+  // Output stream appending to a basic_inplace_string through basic_inplace_stringbuf.
+  template<typename Str>
+  class basic_inplace_ostringstream : public std::basic_ostream<typename Str::value_type, typename Str::traits_type> {
+    using base = std::basic_ostream<typename Str::value_type, typename Str::traits_type>;
+
+  public:
+    explicit basic_inplace_ostringstream(Str& str) : base{nullptr}, buf_{str} { this->init(&buf_); }
+
+    basic_inplace_stringbuf<Str>* rdbuf() const noexcept { return const_cast<basic_inplace_stringbuf<Str>*>(&buf_); }
+    Str& str() noexcept { return buf_.str(); }
+    bool truncated() const noexcept { return buf_.truncated(); }
+
+  private:
+    basic_inplace_stringbuf<Str> buf_;
+  };
+
+  template<std::size_t MaxSize>
+  using inplace_stringbuf = basic_inplace_stringbuf<inplace_string<MaxSize>>;
+  template<std::size_t MaxSize>
+  using inplace_ostringstream = basic_inplace_ostringstream<inplace_string<MaxSize>>;
+  template<std::size_t MaxSize>
+  using inplace_wostringstream = basic_inplace_ostringstream<inplace_wstring<MaxSize>>;
+
+}  // namespace mp
@@ -0,0 +1,251 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <mp/inplace_string_algorithm.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <string_view>
+#include <string>
+#include <vector>
+
+using namespace mp;
+
+namespace {
+
+  // short alphabet and lengths to get long common prefixes, duplicates and embedded zeros
+  template<std::size_t N>
+  std::vector<inplace_string<N>> random_strings(std::size_t count, unsigned seed)
+  {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<std::size_t> length(0, N);
+    std::uniform_int_distribution<int> character(0, 3);
+    std::vector<inplace_string<N>> v;
+    for(std::size_t i = 0; i < count; ++i) {
+      std::string s(length(gen), '\0');
+      for(auto& c : s) c = "\0a\x80z"[character(gen)];
+      v.emplace_back(s);
+    }
+    return v;
+  }
+
+  template<typename Container>
+  void check_match_all(const Container& v, std::basic_string_view<typename Container::value_type::value_type> needle)
+  {
+    using view = std::basic_string_view<typename Container::value_type::value_type>;
+    for(auto mode : {inplace_string_match::equal, inplace_string_match::starts_with, inplace_string_match::ends_with}) {
+      std::vector<std::uint64_t> bitmask((v.size() + 63) / 64, ~std::uint64_t{});
+      const auto count = match_all(needle, v.begin(), v.end(), bitmask.data(), mode);
+      std::size_t expected_count = 0;
+      for(std::size_t i = 0; i < bitmask.size() * 64; ++i) {
+        bool expected = false;
+        if(i < v.size()) {
+          const view s{v[i]};
+          if(mode == inplace_string_match::equal) expected = s == needle;
+          else if(mode == inplace_string_match::starts_with) expected = s.substr(0, needle.size()) == needle;
+          else expected = s.size() >= needle.size() && s.substr(s.size() - needle.size()) == needle;
+        }
+        expected_count += expected;
+        EXPECT_EQ(expected, (bitmask[i / 64] >> (i % 64) & 1) != 0)
+            << "mode " << static_cast<int>(mode) << " row " << i;
+      }
+      EXPECT_EQ(expected_count, count);
+    }
+  }
+
+  template<typename Str>
+  void check_match_all_random(unsigned seed)
+  {
+    using char_type = typename Str::value_type;
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<std::size_t> length(0, Str{}.max_size());
+    std::uniform_int_distribution<int> character(0, 2);
+    std::vector<Str> v;
+    for(int i = 0; i < 300; ++i) {
+      std::basic_string<char_type> s(length(gen), char_type{});
+      for(auto& c : s) c = static_cast<char_type>("ab\0"[character(gen)]);
+      v.emplace_back(s);
+    }
+    for(std::size_t i = 0; i < 30; ++i) {
+      const std::basic_string_view<char_type> s{v[i]};
+      for(std::size_t m : {std::size_t{0}, std::min<std::size_t>(1, s.size()), s.size() / 2, s.size()}) {
+        check_match_all(v, s.substr(0, m));
+        check_match_all(v, s.substr(s.size() - m));
+      }
+    }
+    const std::basic_string<char_type> too_long(Str{}.max_size() + 1, char_type{'a'});
+    check_match_all(v, std::basic_string_view<char_type>{too_long});
+  }
+
+  struct size_in_front_policy : default_inplace_string_policy {
+    static constexpr inplace_string_size_placement size_placement = inplace_string_size_placement::front;
+  };
+
+  template<std::size_t N>
+  void check_sort(std::size_t count, unsigned seed)
+  {
+    const auto input = random_strings<N>(count, seed);
+    auto expected = input;
+    std::sort(expected.begin(), expected.end());
+
+    auto v = input;
+    radix_sort(v.begin(), v.end());
+    EXPECT_EQ(expected, v);
+
+    v = input;
+    stable_radix_sort(v.begin(), v.end());
+    EXPECT_EQ(expected, v);
+
+    std::vector<std::uint32_t> indices(input.size());
+    radix_sort_indices(input.begin(), input.end(), indices.begin());
+    for(std::size_t i = 0; i < input.size(); ++i) EXPECT_EQ(expected[i], input[indices[i]]);
+    for(std::size_t i = 1; i < input.size(); ++i) {
+      if(input[indices[i - 1]] == input[indices[i]]) {
+        EXPECT_LT(indices[i - 1], indices[i]);
+      }
+    }
+  }
+
+}  // namespace
+
+TEST(inPlaceStringAlgorithm, RadixSortEmpty)
+{
+  std::vector<inplace_string<8>> v;
+  radix_sort(v.begin(), v.end());
+  stable_radix_sort(v.begin(), v.end());
+  EXPECT_TRUE(v.empty());
+
+  v.emplace_back("abc");
+  radix_sort(v.begin(), v.end());
+  EXPECT_EQ("abc", v.front());
+}
+
+TEST(inPlaceStringAlgorithm, RadixSort1)
+{
+  std::vector<inplace_string<8>> v{"dog", "cat", "", "caterpil", "ca", "\xff", "b", "cat"};
+  radix_sort(v.begin(), v.end());
+  const std::vector<inplace_string<8>> expected{"", "b", "ca", "cat", "cat", "caterpil", "dog", "\xff"};
+  EXPECT_EQ(expected, v);
+}
+
+TEST(inPlaceStringAlgorithm, RadixSortCrossCheck)
+{
+  check_sort<7>(10, 1);
+  check_sort<7>(1000, 2);
+  check_sort<15>(5000, 3);
+  check_sort<64>(3000, 4);
+}
+
+TEST(inPlaceStringAlgorithm, RadixSortCommonPrefix)
+{
+  std::vector<inplace_string<32>> v;
+  for(int i = 99; i >= 0; --i) v.emplace_back("same long prefix " + std::to_string(i % 50));
+  auto expected = v;
+  std::sort(expected.begin(), expected.end());
+  radix_sort(v.begin(), v.end());
+  EXPECT_EQ(expected, v);
+}
+
+TEST(inPlaceStringAlgorithm, RadixSortLongPrefixes)
+{
+  // every character position splits off one string so the buckets nest as deep as the strings are long
+  std::vector<inplace_string<4096>> v;
+  for(std::size_t k = 0; k < 2000; ++k) v.emplace_back(std::string(k, 'a') + (k % 2 ? 'b' : 'c'));
+  std::shuffle(v.begin(), v.end(), std::mt19937{1});
+  const auto input = v;
+  auto expected = v;
+  std::sort(expected.begin(), expected.end());
+
+  radix_sort(v.begin(), v.end());
+  EXPECT_EQ(expected, v);
+
+  v = input;
+  stable_radix_sort(v.begin(), v.end());
+  EXPECT_EQ(expected, v);
+
+  std::vector<std::uint32_t> indices(input.size());
+  radix_sort_indices(input.begin(), input.end(), indices.begin());
+  for(std::size_t i = 0; i < input.size(); ++i) EXPECT_EQ(expected[i], input[indices[i]]);
+}
+
+TEST(inPlaceStringAlgorithm, RadixSortWide)
+{
+  std::vector<inplace_wstring<8>> v{L"xyz", L"abc", L"", L"ab"};
+  radix_sort(v.begin(), v.end());
+  const std::vector<inplace_wstring<8>> expected{L"", L"ab", L"abc", L"xyz"};
+  EXPECT_EQ(expected, v);
+
+  std::vector<std::uint32_t> indices(v.size());
+  radix_sort_indices(v.begin(), v.end(), indices.begin());
+  EXPECT_EQ((std::vector<std::uint32_t>{0, 1, 2, 3}), indices);
+}
+
+TEST(inPlaceStringAlgorithm, MatchAll1)
+{
+  const std::vector<inplace_string<15>> v{"AAPL", "MSFT", "AAPL.O", "", "AAPL", "GOOGL", "XAAPL"};
+  std::uint64_t bitmask = 0;
+  EXPECT_EQ(2u, match_all(inplace_string<15>{"AAPL"}, v.begin(), v.end(), &bitmask));
+  EXPECT_EQ(0b10001u, bitmask);
+  EXPECT_EQ(3u, match_all(std::string_view{"AAPL"}, v.begin(), v.end(), &bitmask, inplace_string_match::starts_with));
+  EXPECT_EQ(0b10101u, bitmask);
+  EXPECT_EQ(3u, match_all(std::string_view{"APL"}, v.begin(), v.end(), &bitmask, inplace_string_match::ends_with));
+  EXPECT_EQ(0b1010001u, bitmask);
+  EXPECT_EQ(7u, match_all(std::string_view{}, v.begin(), v.end(), &bitmask, inplace_string_match::starts_with));
+  EXPECT_EQ(0b1111111u, bitmask);
+  EXPECT_EQ(1u, match_all(std::string_view{}, v.begin(), v.end(), &bitmask));
+  EXPECT_EQ(0b1000u, bitmask);
+}
+
+TEST(inPlaceStringAlgorithm, MatchAllCrossCheck)
+{
+  check_match_all_random<inplace_string<7>>(1);
+  check_match_all_random<inplace_string<15>>(2);
+  check_match_all_random<inplace_string<32>>(3);
+  check_match_all_random<inplace_string<100>>(4);
+  check_match_all_random<inplace_string<300>>(5);
+  check_match_all_random<padded_inplace_string<31>>(6);
+  check_match_all_random<aligned_inplace_string<20>>(7);
+  check_match_all_random<basic_inplace_string<char, 40, std::char_traits<char>, size_in_front_policy>>(8);
+  check_match_all_random<inplace_u16string<20>>(9);
+  check_match_all_random<inplace_wstring<12>>(10);
+  // several strings per vector load
+  check_match_all_random<basic_inplace_string<char, 14, std::char_traits<char>, size_in_front_policy>>(11);
+  check_match_all_random<inplace_u16string<7>>(12);
+  check_match_all_random<padded_inplace_string<7>>(13);
+
+  const std::vector<std::string> strings{"abc", "ab", ""};
+  check_match_all(strings, "ab");
+}
+
+TEST(inPlaceStringAlgorithm, MatchAllDeque)
+{
+  // not one array so the elements have to be compared one at a time
+  const auto v = random_strings<15>(1000, 11);
+  const std::deque<inplace_string<15>> d(v.begin(), v.end());
+  for(std::size_t i = 0; i < 20; ++i) {
+    const std::string_view s{v[i]};
+    check_match_all(d, s);
+    check_match_all(d, s.substr(0, s.size() / 2));
+  }
+}
@@ -0,0 +1,100 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <mp/atomic_inplace_string.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mp;
+
+namespace {
+
+  template<typename Atomic>
+  void check_load_store()
+  {
+    using string = typename Atomic::value_type;
+    Atomic a;
+    EXPECT_EQ("", a.load());
+    a.store("ab");
+    EXPECT_EQ("ab", a.load());
+    a = string(string{}.max_size(), 'x');
+    EXPECT_EQ(std::string(string{}.max_size(), 'x'), static_cast<string>(a));
+    EXPECT_THROW(a.store(std::string(string{}.max_size() + 1, 'y')), std::length_error);
+    EXPECT_EQ(std::string(string{}.max_size(), 'x'), a.load());
+
+    const Atomic b{string{"in"}};
+    EXPECT_EQ("in", b.load());
+  }
+
+  // the writer stores strings made of 'length' copies of the character 'a' + length; a torn read would mix them up
+  template<typename Atomic>
+  void check_concurrent()
+  {
+    using string = typename Atomic::value_type;
+    const std::size_t max_size = string{}.max_size();
+    Atomic a;
+    std::atomic<bool> done{false};
+    std::atomic<bool> failed{false};
+    std::vector<std::thread> readers;
+    for(int t = 0; t < 3; ++t) {
+      readers.emplace_back([&] {
+        while(!done) {
+          const auto s = a.load();
+          for(auto c : s)
+            if(c != static_cast<char>('a' + s.size())) failed = true;
+        }
+      });
+    }
+    for(int i = 0; i < 20000; ++i) {
+      const auto length = static_cast<std::size_t>(i) % (max_size + 1);
+      a.store(string(length, static_cast<char>('a' + length)));
+    }
+    done = true;
+    for(auto& t : readers) t.join();
+    EXPECT_FALSE(failed);
+  }
+
+}  // namespace
+
+TEST(atomicInPlaceString, LoadStore)
+{
+  static_assert(atomic_inplace_string<7>::is_always_lock_free);
+  static_assert(!atomic_inplace_string<63>::is_always_lock_free);
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+  static_assert(atomic_inplace_string<15>::is_always_lock_free);
+#endif
+  EXPECT_TRUE(atomic_inplace_string<7>{}.is_lock_free());
+  check_load_store<atomic_inplace_string<3>>();
+  check_load_store<atomic_inplace_string<7>>();
+  check_load_store<atomic_inplace_string<15>>();
+  check_load_store<atomic_inplace_string<63>>();
+}
+
+TEST(atomicInPlaceString, Concurrent)
+{
+  check_concurrent<atomic_inplace_string<7>>();
+  check_concurrent<atomic_inplace_string<15>>();
+  check_concurrent<atomic_inplace_string<30>>();
+}
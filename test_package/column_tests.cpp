@@ -0,0 +1,149 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <mp/inplace_string_column.h>
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace mp;
+
+namespace {
+
+  using indices = std::vector<std::size_t>;
+
+  template<typename Column, typename Pred>
+  indices expected_rows(const Column& c, Pred pred)
+  {
+    indices v;
+    for(std::size_t i = 0; i < c.size(); ++i)
+      if(pred(c[i])) v.push_back(i);
+    return v;
+  }
+
+}  // namespace
+
+TEST(inPlaceStringColumn, Basics)
+{
+  inplace_string_column<8> c{"abc", "", "abcdefgh"};
+  EXPECT_EQ(3u, c.size());
+  EXPECT_EQ("abc", c[0]);
+  EXPECT_EQ("", c[1]);
+  EXPECT_EQ("abcdefgh", c.back());
+  EXPECT_EQ(8u, c.length(2));
+  EXPECT_EQ(inplace_string<8>{"abc"}, c.get(0));
+  EXPECT_THROW(c.at(3), std::out_of_range);
+  EXPECT_THROW(c.push_back("too long!"), std::length_error);
+  EXPECT_EQ(3u, c.size());
+
+  c.set(2, "x");
+  EXPECT_EQ("x", c[2]);
+  const std::string tail(c.chars() + 2 * c.stride + 1, 7);
+  EXPECT_EQ(std::string(7, '\0'), tail);
+
+  c.push_back(inplace_string<8>{"def"});
+  const std::vector<std::string_view> rows{c.begin(), c.end()};
+  EXPECT_EQ((std::vector<std::string_view>{"abc", "", "x", "def"}), rows);
+  EXPECT_EQ(4, c.end() - c.begin());
+
+  c.pop_back();
+  c.resize(5);
+  EXPECT_EQ("", c[4]);
+  EXPECT_EQ((inplace_string_column<8>{"abc", "", "x", "", ""}), c);
+
+  c.clear();
+  EXPECT_TRUE(c.empty());
+}
+
+TEST(inPlaceStringColumn, Filters)
+{
+  inplace_string_column<32> c{"apple", "", "apricot", "apple", "banana", "app", "apple pie", "applf"};
+  indices v;
+  c.filter_length(5, 7, std::back_inserter(v));
+  EXPECT_EQ((indices{0, 2, 3, 4, 7}), v);
+
+  v.clear();
+  c.filter_prefix("app", std::back_inserter(v));
+  EXPECT_EQ((indices{0, 3, 5, 6, 7}), v);
+
+  v.clear();
+  c.filter_equal("apple", std::back_inserter(v));
+  EXPECT_EQ((indices{0, 3}), v);
+  EXPECT_EQ(2u, c.count_equal("apple"));
+  EXPECT_EQ(1u, c.count_equal(""));
+  EXPECT_EQ(0u, c.count_equal(std::string(33, 'a')));
+
+  v.clear();
+  c.filter_prefix("", std::back_inserter(v));
+  EXPECT_EQ(c.size(), v.size());
+}
+
+TEST(inPlaceStringColumn, FiltersCrossCheck)
+{
+  std::mt19937 gen(5);
+  std::uniform_int_distribution<std::size_t> length(0, 32);
+  std::uniform_int_distribution<int> character(0, 2);
+  inplace_string_column<32> c;
+  for(int i = 0; i < 1000; ++i) {
+    std::string s(length(gen), '\0');
+    for(auto& ch : s) ch = "ab\0"[character(gen)];
+    c.push_back(s);
+  }
+
+  for(std::size_t lo = 0; lo <= 33; lo += 3) {
+    for(std::size_t hi = lo; hi <= 40; hi += 5) {
+      indices v;
+      c.filter_length(lo, hi, std::back_inserter(v));
+      EXPECT_EQ(expected_rows(c, [&](std::string_view s) { return lo <= s.size() && s.size() <= hi; }), v);
+    }
+  }
+  for(std::size_t i = 0; i < 50; ++i) {
+    for(std::size_t m : {std::size_t{0}, std::size_t{1}, std::size_t{3}, c[i].size() / 2, c[i].size()}) {
+      const auto prefix = c[i].substr(0, m);
+      indices v;
+      c.filter_prefix(prefix, std::back_inserter(v));
+      EXPECT_EQ(expected_rows(c, [&](std::string_view s) { return s.substr(0, prefix.size()) == prefix; }), v);
+    }
+    const std::string needle{c[i]};
+    indices v;
+    c.filter_equal(needle, std::back_inserter(v));
+    EXPECT_EQ(expected_rows(c, [&](std::string_view s) { return s == needle; }), v);
+  }
+}
+
+TEST(inPlaceStringColumn, Wide)
+{
+  inplace_wstring_column<300> c{L"abc", L"ab", std::wstring(300, L'a'), L"abcdefghijk"};
+  indices v;
+  c.filter_prefix(L"ab", std::back_inserter(v));
+  EXPECT_EQ((indices{0, 1, 3}), v);
+  v.clear();
+  c.filter_length(3, 299, std::back_inserter(v));
+  EXPECT_EQ((indices{0, 3}), v);
+  EXPECT_EQ(1u, c.count_equal(std::wstring(300, L'a')));
+  v.clear();
+  c.filter_prefix(L"abcdefghij", std::back_inserter(v));
+  EXPECT_EQ((indices{3}), v);
+}
@@ -0,0 +1,81 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <mp/inplace_string_concurrent_set.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mp;
+
+TEST(inPlaceStringConcurrentSet, Insert)
+{
+  inplace_string_concurrent_set<8> set;
+  EXPECT_TRUE(set.empty());
+  EXPECT_TRUE(set.insert("abc"));
+  EXPECT_FALSE(set.insert(inplace_string<8>{"abc"}));
+  EXPECT_TRUE(set.insert(std::string{}));
+  EXPECT_EQ(2u, set.size());
+  EXPECT_TRUE(set.contains("abc"));
+  EXPECT_TRUE(set.contains(""));
+  EXPECT_FALSE(set.contains("ab"));
+  EXPECT_FALSE(set.contains("longer than eight"));
+  EXPECT_THROW(set.insert("longer than eight"), std::length_error);
+}
+
+TEST(inPlaceStringConcurrentSet, Grow)
+{
+  inplace_string_concurrent_set<15> set;
+  for(int i = 0; i < 20000; ++i) ASSERT_TRUE(set.insert(std::to_string(i)));
+  EXPECT_EQ(20000u, set.size());
+  for(int i = 0; i < 20000; ++i) ASSERT_FALSE(set.insert(std::to_string(i)));
+  for(int i = 0; i < 20000; ++i) ASSERT_TRUE(set.contains(std::to_string(i)));
+  EXPECT_FALSE(set.contains("20000"));
+}
+
+TEST(inPlaceStringConcurrentSet, Concurrent)
+{
+  constexpr int threads_count = 8;
+  constexpr int count = 5000;
+  inplace_string_concurrent_set<36> set{1000};
+  std::atomic<int> inserted{0};
+  std::atomic<bool> failed{false};
+  std::vector<std::thread> threads;
+  // every key is inserted by two threads; exactly one of them has to succeed
+  for(int t = 0; t < threads_count; ++t) {
+    threads.emplace_back([&, t] {
+      for(int i = 0; i < count; ++i) {
+        const auto key = "key-" + std::to_string(i + t / 2 * count);
+        if(set.insert(key)) ++inserted;
+        if(!set.contains(key)) failed = true;
+      }
+    });
+  }
+  for(auto& t : threads) t.join();
+  EXPECT_FALSE(failed);
+  EXPECT_EQ(threads_count / 2 * count, inserted);
+  EXPECT_EQ(static_cast<std::size_t>(threads_count / 2 * count), set.size());
+  for(int i = 0; i < threads_count / 2 * count; ++i) ASSERT_TRUE(set.contains("key-" + std::to_string(i)));
+}
@@ -0,0 +1,132 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <mp/inplace_string_format.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+using namespace mp;
+
+namespace {
+
+  template<inplace_string_overflow Overflow>
+  struct overflow_policy : default_inplace_string_policy {
+    static constexpr inplace_string_overflow overflow = Overflow;
+  };
+
+  template<std::size_t MaxSize, inplace_string_overflow Overflow>
+  using overflow_string = basic_inplace_string<char, MaxSize, std::char_traits<char>, overflow_policy<Overflow>>;
+
+}  // namespace
+
+TEST(inPlaceStringFormat, Appender1)
+{
+  inplace_string<16> str{"id="};
+  const std::string_view text{"12345"};
+  auto it = std::copy(text.begin(), text.end(), appender(str));
+  *it++ = ';';
+  std::fill_n(it, 3, 'x');
+  EXPECT_EQ("id=12345;xxx", str);
+  EXPECT_FALSE(it.truncated());
+}
+
+TEST(inPlaceStringFormat, AppenderOverflow)
+{
+  inplace_string<4> str{"ab"};
+  const std::string_view text{"cde"};
+  EXPECT_THROW(std::copy(text.begin(), text.end(), appender(str)), std::length_error);
+  EXPECT_EQ("abcd", str);
+
+  overflow_string<4, inplace_string_overflow::truncate> truncating{"ab"};
+  const auto it = std::copy(text.begin(), text.end(), appender(truncating));
+  EXPECT_TRUE(it.truncated());
+  EXPECT_EQ("abcd", truncating);
+
+  // a code point is never split and nothing is appended after the first dropped character
+  overflow_string<4, inplace_string_overflow::truncate_utf8> utf8{"ab"};
+  const std::string_view euro{"\xE2\x82\xAC" "c"};
+  EXPECT_TRUE(std::copy(euro.begin(), euro.end(), appender(utf8)).truncated());
+  EXPECT_EQ("ab", utf8);
+
+  basic_inplace_string<char16_t, 3, std::char_traits<char16_t>, overflow_policy<inplace_string_overflow::truncate_utf8>>
+      utf16{u"ab"};
+  const std::u16string_view smile{u"\U0001F600"};
+  EXPECT_TRUE(std::copy(smile.begin(), smile.end(), appender(utf16)).truncated());
+  EXPECT_EQ(u"ab", utf16);
+}
+
+#if defined(MP_INPLACE_STRING_FORMAT)
+
+TEST(inPlaceStringFormat, Formatter1)
+{
+  const inplace_string<8> name{"AAPL"};
+  EXPECT_EQ("[AAPL]", std::format("[{}]", name));
+  EXPECT_EQ("[AAPL    ]", std::format("[{:8}]", name));
+  EXPECT_EQ("[  AAPL]", std::format("[{:>6}]", name));
+  EXPECT_EQ("AA", std::format("{:.2}", name));
+  EXPECT_EQ(L"<ab>", std::format(L"<{}>", inplace_wstring<4>{L"ab"}));
+}
+
+TEST(inPlaceStringFormat, FormatTo1)
+{
+  inplace_string<32> str{"px="};
+  const auto r = format_to(str, "{:.2f}|{}|{:>4}", 101.256, 42, inplace_string<4>{"ab"});
+  EXPECT_TRUE(r);
+  EXPECT_EQ(14u, r.count);
+  EXPECT_EQ("px=101.26|42|  ab", str);
+
+  inplace_wstring<8> wide;
+  EXPECT_TRUE(format_to(wide, L"{}-{}", 1, 2));
+  EXPECT_EQ(L"1-2", wide);
+
+  inplace_string<16> iterated;
+  std::format_to(appender(iterated), "{}+{}", 1, 2);
+  EXPECT_EQ("1+2", iterated);
+  std::format_to_n(appender(iterated), 3, "{}", 123456);
+  EXPECT_EQ("1+2123", iterated);
+}
+
+TEST(inPlaceStringFormat, FormatToOverflow)
+{
+  inplace_string<8> str{"abc"};
+  EXPECT_THROW(format_to(str, "{}", 123456), std::length_error);
+  EXPECT_EQ("abc", str);
+
+  padded_inplace_string<8> padded{"abc"};
+  EXPECT_THROW(format_to(padded, "{}", 123456), std::length_error);
+  EXPECT_EQ(padded_inplace_string<8>{"abc"}, padded);
+
+  overflow_string<8, inplace_string_overflow::truncate> truncating{"abc"};
+  const auto r = format_to(truncating, "{}", 123456);
+  EXPECT_EQ(std::errc::value_too_large, r.ec);
+  EXPECT_EQ(5u, r.count);
+  EXPECT_EQ("abc12345", truncating);
+
+  overflow_string<6, inplace_string_overflow::truncate_utf8> utf8{"abc"};
+  EXPECT_FALSE(format_to(utf8, "x{}", "\xE2\x82\xAC"));
+  EXPECT_EQ("abcx", utf8);
+}
+
+#endif
@@ -0,0 +1,141 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <mp/inplace_string_map.h>
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+
+// explicit instantiation needed to make code coverage metrics work correctly
+template class mp::basic_inplace_string_map<mp::inplace_string<16>, int>;
+
+using namespace mp;
+
+TEST(inPlaceStringMap, DefaultConstructor)
+{
+  inplace_string_map<16, int> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(0u, map.size());
+  EXPECT_EQ(map.begin(), map.end());
+  EXPECT_EQ(map.end(), map.find("abc"));
+  EXPECT_FALSE(map.contains("abc"));
+  EXPECT_EQ(0u, map.erase(inplace_string<16>{"abc"}));
+}
+
+TEST(inPlaceStringMap, Insert1)
+{
+  inplace_string_map<16, int> map;
+  const auto r1 = map.insert({inplace_string<16>{"abc"}, 1});
+  EXPECT_TRUE(r1.second);
+  EXPECT_EQ("abc", r1.first->first);
+  EXPECT_EQ(1, r1.first->second);
+  const auto r2 = map.insert({inplace_string<16>{"abc"}, 2});
+  EXPECT_FALSE(r2.second);
+  EXPECT_EQ(1, r2.first->second);
+  EXPECT_EQ(1u, map.size());
+  map.insert_or_assign("abc", 3);
+  EXPECT_EQ(3, map.at("abc"));
+  map["def"] = 4;
+  EXPECT_EQ(2u, map.size());
+  EXPECT_EQ(4, map.at("def"));
+  EXPECT_THROW(map.at("ghi"), std::out_of_range);
+}
+
+TEST(inPlaceStringMap, HeterogeneousLookup1)
+{
+  inplace_string_map<4, int> map{{inplace_string<4>{"abcd"}, 1}};
+  EXPECT_NE(map.end(), map.find(std::string_view{"abcd"}));
+  EXPECT_NE(map.end(), map.find(std::string{"abcd"}));
+  EXPECT_EQ(1u, map.count("abcd"));
+  EXPECT_EQ(map.end(), map.find(std::string_view{"abcde"}));
+  EXPECT_FALSE(map.contains("abc"));
+}
+
+TEST(inPlaceStringMap, Erase1)
+{
+  inplace_string_map<16, int> map{{inplace_string<16>{"a"}, 1}, {inplace_string<16>{"b"}, 2}};
+  EXPECT_EQ(1u, map.erase(inplace_string<16>{"a"}));
+  EXPECT_EQ(0u, map.erase(inplace_string<16>{"a"}));
+  EXPECT_EQ(1u, map.size());
+  EXPECT_FALSE(map.contains("a"));
+  EXPECT_TRUE(map.contains("b"));
+  const auto it = map.erase(map.find("b"));
+  EXPECT_EQ(map.end(), it);
+  EXPECT_TRUE(map.empty());
+}
+
+TEST(inPlaceStringMap, CrossCheck1)
+{
+  // random inserts and erases compared with std::map, including growth and reuse of deleted slots
+  inplace_string_map<24, std::size_t> map;
+  std::map<std::string, std::size_t> ref;
+  std::uint64_t seed = 42;
+  for(std::size_t i = 0; i < 20000; ++i) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    const auto key = "key_" + std::to_string((seed >> 33) % 3000);
+    if((seed >> 20) % 3 == 0) {
+      EXPECT_EQ(ref.erase(key), map.erase(inplace_string<24>{key}));
+    }
+    else {
+      EXPECT_EQ(ref.emplace(key, i).second, map.try_emplace(inplace_string<24>{key}, i).second);
+    }
+  }
+  EXPECT_EQ(ref.size(), map.size());
+  std::size_t count = 0;
+  for(const auto& v : map) {
+    ++count;
+    const auto it = ref.find(to_string(v.first));
+    ASSERT_NE(ref.end(), it);
+    EXPECT_EQ(it->second, v.second);
+  }
+  EXPECT_EQ(ref.size(), count);
+  for(const auto& v : ref) EXPECT_EQ(v.second, map.at(inplace_string<24>{v.first}));
+}
+
+TEST(inPlaceStringMap, NonTrivialValue1)
+{
+  inplace_string_map<8, std::unique_ptr<std::string>> map;
+  for(int i = 0; i < 1000; ++i)
+    map.try_emplace(inplace_string<8>{std::to_string(i)}, std::make_unique<std::string>(std::to_string(i)));
+  EXPECT_EQ(1000u, map.size());
+  for(int i = 0; i < 1000; ++i) EXPECT_EQ(std::to_string(i), *map.at(inplace_string<8>{std::to_string(i)}));
+
+  auto moved = std::move(map);
+  EXPECT_EQ(1000u, moved.size());
+  EXPECT_TRUE(map.empty());
+  moved.clear();
+  EXPECT_TRUE(moved.empty());
+  EXPECT_FALSE(moved.contains("1"));
+}
+
+TEST(inPlaceStringMap, Copy1)
+{
+  inplace_string_map<8, std::string> map;
+  for(int i = 0; i < 100; ++i) map[inplace_string<8>{std::to_string(i)}] = std::to_string(i * 2);
+  const auto copy = map;
+  EXPECT_EQ(100u, copy.size());
+  for(int i = 0; i < 100; ++i) EXPECT_EQ(std::to_string(i * 2), copy.at(inplace_string<8>{std::to_string(i)}));
+  map.reserve(1000);
+  EXPECT_LE(1000u, map.capacity() * 7 / 8);
+  EXPECT_EQ("20", map.at("10"));
+}
@@ -0,0 +1,101 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <mp/inplace_string_pool.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mp;
+
+TEST(inPlaceStringPool, Intern)
+{
+  inplace_string_pool<8> pool{4};
+  EXPECT_TRUE(pool.empty());
+  EXPECT_EQ(4u, pool.capacity());
+  EXPECT_EQ(0u, pool.intern("abc"));
+  EXPECT_EQ(1u, pool.intern(std::string{"def"}));
+  EXPECT_EQ(0u, pool.intern(inplace_string<8>{"abc"}));
+  EXPECT_EQ(2u, pool.intern(""));
+  EXPECT_EQ(3u, pool.size());
+
+  EXPECT_EQ("abc", pool[0]);
+  EXPECT_EQ("def", pool.at(1));
+  EXPECT_EQ("", pool[2]);
+  EXPECT_THROW(pool.at(3), std::out_of_range);
+
+  EXPECT_EQ(1u, pool.find("def"));
+  EXPECT_EQ(pool.npos, pool.find("xyz"));
+  EXPECT_EQ(pool.npos, pool.find("longer than eight"));
+  EXPECT_TRUE(pool.contains(""));
+  EXPECT_FALSE(pool.contains("x"));
+
+  EXPECT_EQ(3u, pool.intern("12345678"));
+  EXPECT_THROW(pool.intern("one more"), std::length_error);
+  EXPECT_THROW(pool.intern("too long string"), std::length_error);
+  EXPECT_EQ(0u, pool.intern("abc"));
+  EXPECT_EQ(4u, pool.size());
+}
+
+TEST(inPlaceStringPool, Many)
+{
+  inplace_string_pool<15> pool{10000};
+  for(std::uint32_t i = 0; i < 10000; ++i) ASSERT_EQ(i, pool.intern(std::to_string(i * 7)));
+  for(std::uint32_t i = 0; i < 10000; ++i) {
+    ASSERT_EQ(i, pool.find(std::to_string(i * 7)));
+    ASSERT_EQ(std::to_string(i * 7), pool[i]);
+  }
+  EXPECT_EQ(pool.npos, pool.find("1"));
+}
+
+TEST(inPlaceStringPool, Concurrent)
+{
+  constexpr std::uint32_t count = 2000;
+  inplace_string_pool<15> pool{count};
+  std::atomic<bool> failed{false};
+  std::vector<std::thread> threads;
+  // writers intern overlapping sets of strings while readers look up the ones already added
+  for(int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      for(std::uint32_t i = 0; i < count; ++i) {
+        const auto s = std::to_string((i + t * 500) % count);
+        const auto id = pool.intern(s);
+        if(pool[id] != s) failed = true;
+      }
+    });
+    threads.emplace_back([&] {
+      for(std::uint32_t i = 0; i < count; ++i) {
+        const auto s = std::to_string(i);
+        const auto id = pool.find(s);
+        if(id != pool.npos && pool[id] != s) failed = true;
+      }
+    });
+  }
+  for(auto& t : threads) t.join();
+  EXPECT_FALSE(failed);
+  EXPECT_EQ(count, pool.size());
+  for(std::uint32_t i = 0; i < count; ++i) EXPECT_EQ(i, pool.find(pool[i]));
+}
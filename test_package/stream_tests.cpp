@@ -0,0 +1,181 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016 Mateusz Pusz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <mp/inplace_string_stream.h>
+#include <gtest/gtest.h>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+using namespace mp;
+
+namespace {
+
+  template<inplace_string_overflow Overflow>
+  struct overflow_policy : default_inplace_string_policy {
+    static constexpr inplace_string_overflow overflow = Overflow;
+  };
+
+  template<std::size_t MaxSize, inplace_string_overflow Overflow>
+  using overflow_string = basic_inplace_string<char, MaxSize, std::char_traits<char>, overflow_policy<Overflow>>;
+
+  struct padded_utf8_policy : zero_padded_inplace_string_policy {
+    static constexpr inplace_string_overflow overflow = inplace_string_overflow::truncate_utf8;
+  };
+
+}  // namespace
+
+TEST(inPlaceStringStream, Insertion)
+{
+  std::ostringstream os;
+  const inplace_string<8> str{std::string_view{"a\0b", 3}};
+  os << str << '|' << std::setw(5) << inplace_string<8>{"xy"} << '|' << std::left << std::setw(4)
+     << std::setfill('.') << inplace_string<8>{"z"} << '|';
+  EXPECT_EQ((std::string{"a\0b|   xy|z...|", 15}), os.str());
+
+  std::wostringstream wos;
+  wos << inplace_wstring<8>{L"wide"};
+  EXPECT_EQ(L"wide", wos.str());
+}
+
+TEST(inPlaceStringStream, Extraction)
+{
+  std::istringstream is{"  first second\tthird_is_too_long\n"};
+  inplace_string<8> str{"old"};
+  EXPECT_TRUE(is >> str);
+  EXPECT_EQ("first", str);
+  EXPECT_TRUE(is >> std::setw(4) >> str);
+  EXPECT_EQ("seco", str);
+  EXPECT_EQ(0, is.width());
+  EXPECT_TRUE(is >> str);
+  EXPECT_EQ("nd", str);
+  EXPECT_TRUE(is >> str);
+  EXPECT_EQ("third_is", str);
+  EXPECT_TRUE(is >> str);
+  EXPECT_EQ("_too_lon", str);
+  EXPECT_TRUE(is >> str);
+  EXPECT_EQ("g", str);
+  EXPECT_FALSE(is >> str);
+  EXPECT_TRUE(is.eof());
+  EXPECT_EQ("g", str);
+
+  std::istringstream last{"end"};
+  EXPECT_TRUE(last >> str);
+  EXPECT_EQ("end", str);
+  EXPECT_TRUE(last.eof());
+
+  padded_inplace_string<8> padded{"abcdefgh"};
+  std::istringstream short_word{"xy z"};
+  EXPECT_TRUE(short_word >> padded);
+  EXPECT_EQ("xy", padded);
+  EXPECT_EQ('\0', padded.data()[2]);
+
+  std::wistringstream wis{L" wide words"};
+  inplace_wstring<8> wstr;
+  EXPECT_TRUE(wis >> wstr);
+  EXPECT_EQ(L"wide", wstr);
+}
+
+TEST(inPlaceStringStream, Getline)
+{
+  std::istringstream is{"line 1\n\nexactly8\nthis one is too long\nlast"};
+  inplace_string<8> str;
+  EXPECT_TRUE(getline(is, str));
+  EXPECT_EQ("line 1", str);
+  EXPECT_TRUE(mp::getline(is, str));
+  EXPECT_EQ("", str);
+  EXPECT_TRUE(getline(is, str));
+  EXPECT_EQ("exactly8", str);
+  EXPECT_FALSE(getline(is, str));
+  EXPECT_EQ("this one", str);
+  is.clear();
+  EXPECT_FALSE(getline(is, str));
+  EXPECT_EQ(" is too ", str);
+  is.clear();
+  EXPECT_TRUE(getline(is, str));
+  EXPECT_EQ("long", str);
+  EXPECT_TRUE(getline(is, str));
+  EXPECT_EQ("last", str);
+  EXPECT_TRUE(is.eof());
+  EXPECT_FALSE(getline(is, str));
+
+  std::istringstream fields{"a,b,,c"};
+  inplace_string<4> field;
+  std::string joined;
+  while(getline(fields, field, ',')) joined += std::string{field} + ";";
+  EXPECT_EQ("a;b;;c;", joined);
+
+  basic_inplace_string<char, 8, std::char_traits<char>, overflow_policy<inplace_string_overflow::truncate>> other;
+  std::istringstream spaces{"  keep spaces  "};
+  EXPECT_FALSE(getline(spaces, other));
+  EXPECT_EQ("  keep s", other);
+}
+
+TEST(inPlaceStringStream, OStringStream)
+{
+  inplace_string<32> str{"x="};
+  {
+    inplace_ostringstream<32> os{str};
+    os << 42 << ", y=" << 1.5 << ' ' << inplace_string<8>{"ok"};
+    EXPECT_EQ("x=42, y=1.5 ok", os.str());
+    os << std::setw(4) << 7;
+    EXPECT_TRUE(os);
+    EXPECT_FALSE(os.truncated());
+  }
+  EXPECT_EQ("x=42, y=1.5 ok   7", str);
+
+  inplace_wstring<8> wstr;
+  inplace_wostringstream<8> wos{wstr};
+  wos << L"w" << 12 << std::flush;
+  EXPECT_EQ(L"w12", wstr);
+}
+
+TEST(inPlaceStringStream, OStringStreamOverflow)
+{
+  inplace_string<4> str{"ab"};
+  {
+    inplace_ostringstream<4> os{str};
+    os << "cdef";
+    EXPECT_TRUE(os.bad());
+    EXPECT_EQ("abcd", os.str());
+  }
+  EXPECT_EQ("abcd", str);
+
+  overflow_string<4, inplace_string_overflow::truncate> truncating{"ab"};
+  {
+    basic_inplace_ostringstream<decltype(truncating)> os{truncating};
+    os << "cdef" << 'g';
+    EXPECT_TRUE(os);
+    EXPECT_TRUE(os.truncated());
+  }
+  EXPECT_EQ("abcd", truncating);
+
+  using utf8_string = basic_inplace_string<char, 4, std::char_traits<char>, padded_utf8_policy>;
+  utf8_string utf8{"ab"};
+  basic_inplace_ostringstream<utf8_string> os{utf8};
+  os << "\xE2\x82\xAC" << "c";
+  EXPECT_TRUE(os.truncated());
+  EXPECT_EQ("ab", os.str());
+  EXPECT_EQ('\0', utf8.data()[2]);
+  EXPECT_EQ('\0', utf8.data()[3]);
+}
@@ -22,11 +22,36 @@
 
 #include <mp/inplace_string.h>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
 
 // explicit instantiation needed to make code coverage metrics work correctly
 template class mp::basic_inplace_string<char, 16, std::char_traits<char>>;
+template class mp::basic_inplace_string<char, 16, std::char_traits<char>, mp::zero_padded_inplace_string_policy>;
+
+namespace {
+
+  template<mp::inplace_string_overflow Overflow>
+  struct overflow_policy : mp::default_inplace_string_policy {
+    static constexpr mp::inplace_string_overflow overflow = Overflow;
+  };
+
+}  // namespace
+
+template class mp::basic_inplace_string<char, 16, std::char_traits<char>,
+                                        overflow_policy<mp::inplace_string_overflow::truncate_utf8>>;
 
 using namespace mp;
+constexpr auto npos = std::string_view::npos;
 
 TEST(inPlaceString, CompileTime) { static_assert(sizeof(inplace_string<8>) == sizeof("01234567"), ""); }
 
@@ -1533,6 +1558,76 @@ TEST(inPlaceString, AssignIlist1)
 }
 
 
+TEST(inPlaceString, AssignLiteral1)
+{
+  inplace_string<4> str{"test"};
+  EXPECT_EQ(4u, str.size());
+  EXPECT_STREQ("test", str.c_str());
+  str.assign("ab");
+  EXPECT_EQ(2u, str.size());
+  EXPECT_EQ("ab", str);
+  str = "xyz";
+  EXPECT_EQ(3u, str.size());
+  EXPECT_EQ("xyz", str);
+  str = "";
+  EXPECT_TRUE(str.empty());
+}
+
+TEST(inPlaceString, AssignLiteral2)
+{
+  // embedded zeros keep the C-string semantics
+  padded_inplace_string<8> str{"te\0st"};
+  EXPECT_EQ(2u, str.size());
+  EXPECT_EQ(padded_inplace_string<8>{"te"}, str);
+
+  // modifiable buffer bigger than max_size() with a shorter content
+  char buffer[64] = "abc";
+  str.assign(buffer);
+  EXPECT_EQ("abc", str);
+  str = buffer;
+  EXPECT_EQ("abc", str);
+  EXPECT_EQ("abc", inplace_string<4>{buffer});
+
+  const char* ptr = "ptr";
+  str = ptr;
+  EXPECT_EQ("ptr", str);
+}
+
+TEST(inPlaceString, AssignLiteral3)
+{
+  // constant array bigger than max_size() with a shorter content
+  struct record {
+    const char name[32] = "abc";
+    const char code[12] = "0123456789";
+  };
+  const record r;
+  inplace_string<8> str{r.name};
+  EXPECT_EQ(3u, str.size());
+  EXPECT_EQ("abc", str);
+  str = r.name;
+  EXPECT_EQ("abc", str);
+  EXPECT_EQ("abc", inplace_string<8>{}.assign(r.name));
+
+  // a longer content is handled by the overflow policy
+  EXPECT_THROW(inplace_string<8>{r.code}, std::length_error);
+  EXPECT_THROW(str = r.code, std::length_error);
+  const basic_inplace_string<char, 8, std::char_traits<char>, overflow_policy<inplace_string_overflow::truncate>>
+      truncated{r.code};
+  EXPECT_EQ("01234567", truncated);
+}
+
+#if __cplusplus > 201703L
+
+TEST(inPlaceString, AssignLiteralCompileTime)
+{
+  constexpr inplace_string<8> str{"literal"};
+  static_assert(str.size() == 7);
+  static_assert(str[6] == 'l');
+}
+
+#endif
+
+
 TEST(inPlaceString, AssignNC1)
 {
   inplace_string<16> str;
@@ -1617,3 +1712,1094 @@ TEST(inPlaceString, AssignIter3)
   EXPECT_EQ("", str);
   EXPECT_EQ(std::begin(str), std::end(str));
 }
+
+TEST(inPlaceString, Find1)
+{
+  inplace_string<16> str{"abcabcd"};
+  EXPECT_EQ(0u, str.find('a'));
+  EXPECT_EQ(3u, str.find('a', 1));
+  EXPECT_EQ(6u, str.find('d'));
+  EXPECT_EQ(inplace_string<16>::npos, str.find('x'));
+  EXPECT_EQ(inplace_string<16>::npos, str.find('a', 100));
+}
+
+TEST(inPlaceString, Find2)
+{
+  inplace_string<16> str{"abcabcd"};
+  EXPECT_EQ(0u, str.find("abc"));
+  EXPECT_EQ(3u, str.find("abc", 1));
+  EXPECT_EQ(3u, str.find("abcd"));
+  EXPECT_EQ(2u, str.find("", 2));
+  EXPECT_EQ(7u, str.find("", 7));
+  EXPECT_EQ(inplace_string<16>::npos, str.find("", 8));
+  EXPECT_EQ(inplace_string<16>::npos, str.find("abcabcde"));
+  EXPECT_EQ(4u, str.find(std::string_view{"bcd"}));
+  EXPECT_EQ(1u, str.find(inplace_string<4>{"bc"}));
+}
+
+TEST(inPlaceString, RFind1)
+{
+  inplace_string<16> str{"abcabcd"};
+  EXPECT_EQ(3u, str.rfind('a'));
+  EXPECT_EQ(0u, str.rfind('a', 2));
+  EXPECT_EQ(inplace_string<16>::npos, str.rfind('d', 5));
+  EXPECT_EQ(3u, str.rfind("abc"));
+  EXPECT_EQ(0u, str.rfind("abc", 2));
+  EXPECT_EQ(7u, str.rfind(""));
+  EXPECT_EQ(inplace_string<16>::npos, inplace_string<16>{}.rfind('a'));
+}
+
+TEST(inPlaceString, FindFirstOf1)
+{
+  inplace_string<16> str{"key=value;x"};
+  EXPECT_EQ(3u, str.find_first_of("=;"));
+  EXPECT_EQ(9u, str.find_first_of("=;", 4));
+  EXPECT_EQ(inplace_string<16>::npos, str.find_first_of("#"));
+  EXPECT_EQ(9u, str.find_last_of("=;"));
+  EXPECT_EQ(3u, str.find_last_of("=;", 8));
+  EXPECT_EQ(3u, str.find_first_not_of("eky"));
+  EXPECT_EQ(9u, str.find_last_not_of("x"));
+  EXPECT_EQ(inplace_string<16>::npos, str.find_first_not_of("key=value;x"));
+}
+
+namespace {
+
+  // makes every byte of a wider character matter
+  template<typename CharT>
+  std::basic_string<CharT> widen(const std::string& str)
+  {
+    std::basic_string<CharT> res;
+    for(const auto c : str) {
+      const auto u = static_cast<unsigned char>(c);
+      res += static_cast<CharT>(sizeof(CharT) == 1 ? u : (sizeof(CharT) == 2 ? u * 0x0101u : u * 0x01010101u));
+    }
+    return res;
+  }
+
+  // compares all search members against std::string_view for every position of every needle
+  template<std::size_t MaxSize, typename String = inplace_string<MaxSize>>
+  void check_search(const std::string& narrow_txt, const std::vector<std::string>& narrow_needles)
+  {
+    using char_type = typename String::value_type;
+    const auto txt = widen<char_type>(narrow_txt);
+    const String str{txt.data(), txt.size()};
+    const std::basic_string_view<char_type> sv{txt};
+    for(const auto& narrow_needle : narrow_needles) {
+      const auto n = widen<char_type>(narrow_needle);
+      const auto info = narrow_txt + " / " + narrow_needle;
+      std::vector<std::size_t> positions;
+      for(std::size_t pos = 0; pos <= txt.size() + 1; ++pos) positions.push_back(pos);
+      for(std::size_t k : {0, 1, 15, 16, 31, 32, 64}) positions.push_back(npos - k);
+      for(const auto pos : positions) {
+        EXPECT_EQ(sv.find(n, pos), str.find(n, pos)) << info << " / " << pos;
+        EXPECT_EQ(sv.rfind(n, pos), str.rfind(n, pos)) << info << " / " << pos;
+        EXPECT_EQ(sv.find_first_of(n, pos), str.find_first_of(n, pos)) << info << " / " << pos;
+        EXPECT_EQ(sv.find_last_of(n, pos), str.find_last_of(n, pos)) << info << " / " << pos;
+        EXPECT_EQ(sv.find_first_not_of(n, pos), str.find_first_not_of(n, pos)) << info << " / " << pos;
+        EXPECT_EQ(sv.find_last_not_of(n, pos), str.find_last_not_of(n, pos)) << info << " / " << pos;
+        if(!n.empty()) {
+          EXPECT_EQ(sv.find(n[0], pos), str.find(n[0], pos)) << info << " / " << pos;
+          EXPECT_EQ(sv.rfind(n[0], pos), str.rfind(n[0], pos)) << info << " / " << pos;
+        }
+      }
+      EXPECT_EQ(sv.rfind(n), str.rfind(n)) << info;
+      EXPECT_EQ(sv.find_last_of(n), str.find_last_of(n)) << info;
+      EXPECT_EQ(sv.find_last_not_of(n), str.find_last_not_of(n)) << info;
+    }
+  }
+
+  template<std::size_t MaxSize, typename String = inplace_string<MaxSize>>
+  void check_search_all_lengths()
+  {
+    const std::string pattern{"ab\x80" "cab" "\xff" "dabcab" "\0" "e", 15};
+    const std::vector<std::string> needles = {"",    "a",     "ab",   "abc",  "cab",    "b\x80",
+                                              "\xff", "dab",  "zzz",  "eab",  "abcabd", "xyzab\x80\xff",
+                                              "abcdefghijklmnopqrstuvwxyz"};
+    for(std::size_t len = 0; len <= MaxSize; ++len) {
+      std::string txt;
+      for(std::size_t i = 0; i < len; ++i) txt += pattern[(i * 7 + len) % pattern.size()];
+      check_search<MaxSize, String>(txt, needles);
+    }
+  }
+
+}  // namespace
+
+TEST(inPlaceString, SearchCrossCheckRuns)
+{
+  const std::vector<std::string> needles = {"a", "ab", "aa", "b", "ba", "aaab", "c"};
+  for(std::size_t len = 0; len <= 100; len += 3) {
+    for(std::size_t b = 0; b < len; b += 5) {
+      std::string txt(len, 'a');
+      txt[b] = 'b';
+      check_search<100>(txt, needles);
+    }
+  }
+  // long enough for the C library path
+  check_search<200>(std::string(150, 'a'), needles);
+}
+
+TEST(inPlaceString, SearchCrossCheck8) { check_search_all_lengths<8>(); }
+TEST(inPlaceString, SearchCrossCheck15) { check_search_all_lengths<15>(); }
+TEST(inPlaceString, SearchCrossCheck31) { check_search_all_lengths<31>(); }
+TEST(inPlaceString, SearchCrossCheck64) { check_search_all_lengths<64>(); }
+TEST(inPlaceString, SearchCrossCheck128) { check_search_all_lengths<128>(); }
+TEST(inPlaceString, SearchCrossCheckWide)
+{
+  check_search_all_lengths<8, inplace_u16string<8>>();
+  check_search_all_lengths<40, inplace_u16string<40>>();
+  check_search_all_lengths<8, inplace_u32string<8>>();
+  check_search_all_lengths<40, inplace_u32string<40>>();
+  check_search_all_lengths<20, inplace_wstring<20>>();
+}
+TEST(inPlaceString, SearchCrossCheckAligned)
+{
+  check_search_all_lengths<13, aligned_inplace_string<13>>();
+  check_search_all_lengths<40, aligned_inplace_string<40, 64>>();
+}
+
+namespace {
+
+  template<std::size_t MaxSize>
+  bool tail_is_zero(const padded_inplace_string<MaxSize>& str)
+  {
+    return std::all_of(str.data() + str.size(), str.data() + MaxSize, [](char c) { return c == '\0'; });
+  }
+
+}  // namespace
+
+TEST(inPlaceString, ZeroPadded1)
+{
+  static_assert(sizeof(padded_inplace_string<8>) == sizeof(inplace_string<8>), "");
+  padded_inplace_string<16> str;
+  EXPECT_TRUE(str.empty());
+  EXPECT_TRUE(tail_is_zero(str));
+  str = "abcdefgh";
+  EXPECT_EQ(8u, str.size());
+  EXPECT_TRUE(tail_is_zero(str));
+  str.resize(3);
+  EXPECT_EQ("abc", str);
+  EXPECT_TRUE(tail_is_zero(str));
+  str.append("0123456789");
+  EXPECT_EQ("abc0123456789", str);
+  str.assign(2u, 'x');
+  EXPECT_EQ("xx", str);
+  EXPECT_TRUE(tail_is_zero(str));
+  str.clear();
+  EXPECT_TRUE(tail_is_zero(str));
+}
+
+TEST(inPlaceString, ZeroPaddedEqual1)
+{
+  padded_inplace_string<16> str1{"abcdefghijk"};
+  padded_inplace_string<16> str2{"abc"};
+  EXPECT_NE(str1, str2);
+  str1.resize(3);
+  EXPECT_EQ(str1, str2);
+  str2.push_back('\0');
+  EXPECT_NE(str1, str2);
+  EXPECT_EQ(padded_inplace_string<32>{std::string_view{"0123456789abcdefghijklmnopqrstuv"}},
+            padded_inplace_string<32>{std::string_view{"0123456789abcdefghijklmnopqrstuv"}});
+  EXPECT_NE(padded_inplace_string<32>{std::string_view{"0123456789abcdefghijklmnopqrstuv"}},
+            padded_inplace_string<32>{std::string_view{"0123456789abcdefghijklmnopqrstuV"}});
+  EXPECT_EQ(padded_inplace_string<4>{"ab"}, padded_inplace_string<4>{"ab"});
+  EXPECT_NE(padded_inplace_string<4>{"ab"}, padded_inplace_string<4>{"abc"});
+}
+
+TEST(inPlaceString, Compare1)
+{
+  inplace_string<16> str{"abcd"};
+  EXPECT_EQ(0, str.compare("abcd"));
+  EXPECT_GT(0, str.compare("abce"));
+  EXPECT_LT(0, str.compare("abc"));
+  EXPECT_GT(0, str.compare("abcde"));
+  EXPECT_LT(0, str.compare(""));
+  EXPECT_EQ(0, str.compare(std::string_view{"abcd"}));
+  EXPECT_EQ(0, str.compare(std::string{"abcd"}));
+  EXPECT_EQ(0, str.compare(inplace_string<4>{"abcd"}));
+  EXPECT_GT(0, str.compare(inplace_string<32>{"abcdabcdabcd"}));
+  EXPECT_EQ(0, str.compare(1, 2, "bc"));
+  EXPECT_EQ(0, str.compare(1, 2, "xbcx", 1, 2));
+  EXPECT_EQ(0, str.compare(1, npos, "bcdx", 3));
+  EXPECT_THROW(str.compare(5, 1, "a"), std::out_of_range);
+}
+
+TEST(inPlaceString, Compare2)
+{
+  // bytes are compared as unsigned characters
+  EXPECT_GT(0, inplace_string<32>{"abc\x01"}.compare(inplace_string<32>{"abc\x80"}));
+  EXPECT_LT(0, inplace_string<32>{"abc\xff"}.compare(inplace_string<32>{"abc\x7f"}));
+  EXPECT_GT(0, inplace_string<64>{std::string(40, 'a') + "\x01"}.compare(std::string(40, 'a') + "\xfe"));
+  EXPECT_LT(0, inplace_string<64>{std::string(40, 'a') + "b"}.compare(inplace_string<48>{std::string(40, 'a')}));
+  for(std::size_t len = 1; len <= 64; ++len) {
+    for(std::size_t pos = 0; pos < len; ++pos) {
+      std::string txt(len, 'a');
+      const inplace_string<64> str{txt};
+      txt[pos] = 'b';
+      EXPECT_GT(0, str.compare(inplace_string<64>{txt})) << len << " / " << pos;
+      EXPECT_LT(0, inplace_string<64>{txt}.compare(str)) << len << " / " << pos;
+      EXPECT_GT(0, str.compare(std::string_view{txt})) << len << " / " << pos;
+    }
+  }
+}
+
+TEST(inPlaceString, CompareOperators1)
+{
+  const inplace_string<16> str{"abcd"};
+  const inplace_string<32> other{"abce"};
+  EXPECT_TRUE(str == inplace_string<8>{"abcd"});
+  EXPECT_TRUE(str != other);
+  EXPECT_TRUE(str < other);
+  EXPECT_TRUE(str <= other);
+  EXPECT_TRUE(other > str);
+  EXPECT_TRUE(other >= str);
+  EXPECT_TRUE(str == std::string_view{"abcd"});
+  EXPECT_TRUE(std::string_view{"abcd"} == str);
+  EXPECT_TRUE(str == std::string{"abcd"});
+  EXPECT_TRUE(std::string{"abcd"} == str);
+  EXPECT_TRUE(str < std::string_view{"abce"});
+  EXPECT_TRUE(std::string_view{"abcc"} < str);
+  EXPECT_TRUE("abcc" < str);
+  EXPECT_TRUE(str >= "abcd");
+  EXPECT_TRUE("abcde" > str);
+  EXPECT_TRUE(str != "abc");
+}
+
+#if defined(MP_INPLACE_STRING_THREE_WAY_COMPARISON)
+
+TEST(inPlaceString, ThreeWayCompare1)
+{
+  const inplace_string<16> str{"abcd"};
+  EXPECT_TRUE((str <=> inplace_string<32>{"abce"}) < 0);
+  EXPECT_TRUE((str <=> std::string_view{"abcd"}) == 0);
+  EXPECT_TRUE(("abcc" <=> str) < 0);
+  static_assert(std::is_same_v<decltype(str <=> str), std::strong_ordering>);
+}
+
+#endif
+
+TEST(inPlaceString, Hash1)
+{
+  using hash8 = std::hash<inplace_string<8>>;
+  using hash32 = std::hash<inplace_string<32>>;
+  using hash128 = std::hash<inplace_string<128>>;
+  EXPECT_EQ(hash8{}(inplace_string<8>{"abc"}), hash8{}(inplace_string<8>{"abc"}));
+  EXPECT_NE(hash8{}(inplace_string<8>{"abc"}), hash8{}(inplace_string<8>{"abd"}));
+  EXPECT_NE(hash8{}(inplace_string<8>{""}), hash8{}(inplace_string<8>{std::string_view{"\0", 1}}));
+
+  // kernels specialized on MaxSize produce the same results for the same content
+  for(std::size_t len = 0; len <= 32; ++len) {
+    std::string txt;
+    for(std::size_t i = 0; i < len; ++i) txt += static_cast<char>('a' + i * 5 % 26);
+    EXPECT_EQ(hash32{}(inplace_string<32>{txt}), hash128{}(inplace_string<128>{txt})) << len;
+    if(len <= 8) {
+      EXPECT_EQ(hash8{}(inplace_string<8>{txt}), hash128{}(inplace_string<128>{txt})) << len;
+    }
+  }
+}
+
+TEST(inPlaceString, Hash2)
+{
+  // every prefix of a text and every single character change has to produce a distinct hash
+  std::unordered_set<std::size_t> hashes;
+  std::string txt(255, 'x');
+  std::size_t count = 0;
+  for(std::size_t len = 0; len <= txt.size(); ++len) {
+    hashes.insert(std::hash<inplace_string<255>>{}(inplace_string<255>{std::string_view{txt}.substr(0, len)}));
+    ++count;
+    for(std::size_t pos = 0; pos < len; pos += 7) {
+      std::string changed = txt.substr(0, len);
+      changed[pos] = 'y';
+      hashes.insert(std::hash<inplace_string<255>>{}(inplace_string<255>{changed}));
+      ++count;
+    }
+  }
+  EXPECT_EQ(count, hashes.size());
+}
+
+TEST(inPlaceString, Hash3)
+{
+  using hash = std::hash<padded_inplace_string<16>>;
+  padded_inplace_string<16> str{"abcdefghijk"};
+  str.resize(3);
+  EXPECT_EQ(hash{}(padded_inplace_string<16>{"abc"}), hash{}(str));
+  EXPECT_NE(hash{}(padded_inplace_string<16>{"abd"}), hash{}(str));
+
+  std::unordered_set<inplace_string<16>> set{inplace_string<16>{"abc"}, inplace_string<16>{"def"}};
+  EXPECT_EQ(1u, set.count(inplace_string<16>{"abc"}));
+  EXPECT_EQ(0u, set.count(inplace_string<16>{"abd"}));
+}
+
+TEST(inPlaceString, OverflowThrow)
+{
+  static_assert(!noexcept(std::declval<inplace_string<4>&>().append("abc", 3)));
+  inplace_string<4> str{"abc"};
+  EXPECT_THROW(str.append("de"), std::length_error);
+  str.push_back('d');
+  EXPECT_THROW(str.push_back('e'), std::length_error);
+  EXPECT_EQ("abcd", str);
+  EXPECT_THROW(str.assign(std::string_view{"abcde"}), std::length_error);
+  EXPECT_THROW(str.resize(5), std::length_error);
+  EXPECT_THROW(str.append(2, 'x'), std::length_error);
+  EXPECT_EQ("abcd", str);
+}
+
+TEST(inPlaceString, OverflowTruncate)
+{
+  using string = basic_inplace_string<char, 4, std::char_traits<char>,
+                                      overflow_policy<inplace_string_overflow::truncate>>;
+  static_assert(noexcept(std::declval<string&>().append("abc", 3)));
+  static_assert(noexcept(string{"abc", 3}));
+  string str{std::string_view{"abcdef"}};
+  EXPECT_EQ("abcd", str);
+  str.assign(std::string_view{"ab"});
+  str.append(std::string_view{"cdef"});
+  EXPECT_EQ("abcd", str);
+  str.push_back('x');
+  EXPECT_EQ("abcd", str);
+  str.resize(1);
+  str.resize(100, 'z');
+  EXPECT_EQ("azzz", str);
+  str.assign(string::npos, 'y');
+  EXPECT_EQ("yyyy", str);
+  const std::vector<char> v{'1', '2', '3', '4', '5'};
+  str.assign(v.begin(), v.end());
+  EXPECT_EQ("1234", str);
+}
+
+TEST(inPlaceString, OverflowTruncateUtf8)
+{
+  using string = basic_inplace_string<char, 4, std::char_traits<char>,
+                                      overflow_policy<inplace_string_overflow::truncate_utf8>>;
+  string str{std::string_view{"a\xc5\xbc\xc3\xb3"}};  // a, z with dot above, o acute
+  EXPECT_EQ(std::string_view{"a\xc5\xbc"}, str);
+  str.assign(std::string_view{"ab\xe2\x82\xac"});  // euro sign needs 3 bytes
+  EXPECT_EQ("ab", str);
+  str.append(std::string_view{"\xc3\xb3"});
+  EXPECT_EQ(std::string_view{"ab\xc3\xb3"}, str);
+  str.assign(std::string_view{"abcdef"});
+  EXPECT_EQ("abcd", str);
+
+  using u16string = basic_inplace_string<char16_t, 2, std::char_traits<char16_t>,
+                                         overflow_policy<inplace_string_overflow::truncate_utf8>>;
+  u16string u16{std::u16string_view{u"a\U0001F600"}};  // surrogate pair does not fit
+  EXPECT_EQ(1u, u16.size());
+}
+
+TEST(inPlaceString, OverflowUnchecked)
+{
+  using string = basic_inplace_string<char, 4, std::char_traits<char>,
+                                      overflow_policy<inplace_string_overflow::unchecked>>;
+  static_assert(noexcept(std::declval<string&>().append("abc", 3)));
+  string str{"ab"};
+  str.append(std::string_view{"cd"});
+  EXPECT_EQ("abcd", str);
+}
+
+TEST(inPlaceString, Insert1)
+{
+  inplace_string<16> str{"abef"};
+  str.insert(2, "cd");
+  EXPECT_EQ("abcdef", str);
+  str.insert(0, 2, '-');
+  EXPECT_EQ("--abcdef", str);
+  str.insert(str.size(), std::string_view{"gh"});
+  EXPECT_EQ("--abcdefgh", str);
+  str.insert(1, "xyz", 1);
+  EXPECT_EQ("-x-abcdefgh", str);
+  str.insert(0, std::string_view{str}.substr(3, 3));  // aliasing
+  EXPECT_EQ("abc-x-abcdefgh", str);
+  EXPECT_THROW(str.insert(15, "a"), std::out_of_range);
+  EXPECT_THROW(str.insert(0, "abc"), std::length_error);
+  EXPECT_EQ("abc-x-abcdefgh", str);
+}
+
+TEST(inPlaceString, AssignAliasing1)
+{
+  padded_inplace_string<8> str{"abcdef"};
+  str.assign(std::string_view{str}.substr(2, 3));
+  EXPECT_EQ(padded_inplace_string<8>{"cde"}, str);
+  str.assign(std::string_view{str}.substr(1));
+  EXPECT_EQ(padded_inplace_string<8>{"de"}, str);
+}
+
+TEST(inPlaceString, TryModifiers1)
+{
+  inplace_string<4> str;
+  static_assert(noexcept(str.try_append(std::string_view{"abc"})));
+
+  auto res = str.try_assign("ab");
+  EXPECT_TRUE(res);
+  EXPECT_EQ(2u, res.count);
+  res = str.try_append("cde");
+  EXPECT_FALSE(res);
+  EXPECT_EQ(std::errc::value_too_large, res.ec);
+  EXPECT_EQ(2u, res.count);
+  EXPECT_EQ("abcd", str);
+  res = str.try_push_back('e');
+  EXPECT_EQ(std::errc::value_too_large, res.ec);
+  EXPECT_EQ(0u, res.count);
+  EXPECT_EQ("abcd", str);
+
+  res = str.try_resize(1);
+  EXPECT_TRUE(res);
+  EXPECT_EQ("a", str);
+  res = str.try_resize(10, 'x');
+  EXPECT_EQ(std::errc::value_too_large, res.ec);
+  EXPECT_EQ(3u, res.count);
+  EXPECT_EQ("axxx", str);
+
+  res = str.try_assign(3, 'y');
+  EXPECT_TRUE(res);
+  res = str.try_push_back('z');
+  EXPECT_TRUE(res);
+  EXPECT_EQ("yyyz", str);
+
+  res = str.try_assign("abcdef");
+  EXPECT_EQ(4u, res.count);
+  EXPECT_EQ("abcd", str);
+  res = str.try_append(2, '!');
+  EXPECT_EQ(0u, res.count);
+  EXPECT_FALSE(res);
+}
+
+TEST(inPlaceString, TryModifiers2)
+{
+  inplace_string<6> str{"abf"};
+  auto res = str.try_insert(2, "cdex");
+  EXPECT_EQ(std::errc::value_too_large, res.ec);
+  EXPECT_EQ(3u, res.count);
+  EXPECT_EQ("abcdef", str);
+
+  str.resize(2);
+  res = str.try_insert(1, 2, '-');
+  EXPECT_TRUE(res);
+  EXPECT_EQ("a--b", str);
+  res = str.try_insert(5, "x");
+  EXPECT_EQ(std::errc::invalid_argument, res.ec);
+  EXPECT_EQ("a--b", str);
+  res = str.try_insert(0, std::string_view{str});  // aliasing
+  EXPECT_EQ(2u, res.count);
+  EXPECT_EQ("a-a--b", str);
+
+  using utf8_string = basic_inplace_string<char, 4, std::char_traits<char>,
+                                           overflow_policy<inplace_string_overflow::truncate_utf8>>;
+  utf8_string utf8{"ab"};
+  res = utf8.try_append(std::string_view{"\xe2\x82\xac"});
+  EXPECT_EQ(0u, res.count);
+  EXPECT_EQ("ab", utf8);
+}
+
+namespace {
+
+  struct size_in_front_policy : default_inplace_string_policy {
+    static constexpr inplace_string_size_placement size_placement = inplace_string_size_placement::front;
+  };
+
+  struct padded_size_in_front_policy : zero_padded_inplace_string_policy {
+    static constexpr inplace_string_size_placement size_placement = inplace_string_size_placement::front;
+  };
+
+}  // namespace
+
+TEST(inPlaceString, LargeMaxSize1)
+{
+  static_assert(sizeof(inplace_string<255>) == 256);
+  static_assert(sizeof(inplace_string<256>) == 258);
+  static_assert(sizeof(inplace_string<4096>) == 4098);
+  static_assert(sizeof(inplace_wstring<4096>) == 4097 * sizeof(wchar_t));
+
+  inplace_string<4096> str;
+  EXPECT_TRUE(str.empty());
+  const std::string payload(3000, 'x');
+  str.assign(std::string_view{payload});
+  EXPECT_EQ(3000u, str.size());
+  EXPECT_EQ(payload, str.c_str());
+  str.append(1096, 'y');
+  EXPECT_EQ(4096u, str.size());
+  EXPECT_EQ(str.max_size(), str.size());
+  EXPECT_EQ(4096u, std::char_traits<char>::length(str.c_str()));  // trailer works as the terminator
+  EXPECT_EQ(3000u, str.find('y'));
+  EXPECT_EQ(4095u, str.rfind('y'));
+  EXPECT_THROW(str.push_back('z'), std::length_error);
+  str.resize(257);
+  EXPECT_EQ(257u, str.size());
+  EXPECT_EQ('x', str.back());
+}
+
+TEST(inPlaceString, LargeMaxSize2)
+{
+  using string = basic_inplace_string<char16_t, 70000>;
+  static_assert(sizeof(string) == 70002 * sizeof(char16_t));
+  auto str = std::make_unique<string>(std::u16string_view{u"abc"});
+  EXPECT_EQ(3u, str->size());
+  str->resize(70000, u'z');
+  EXPECT_EQ(70000u, str->size());
+  EXPECT_EQ(u'\0', str->c_str()[70000]);
+}
+
+TEST(inPlaceString, SizeInFront1)
+{
+  using string = basic_inplace_string<char, 16, std::char_traits<char>, size_in_front_policy>;
+  static_assert(sizeof(string) == 18);
+  string str{"abc"};
+  EXPECT_EQ(3u, str.size());
+  EXPECT_EQ(reinterpret_cast<const char*>(&str) + 1, str.data());
+  EXPECT_STREQ("abc", str.c_str());
+  str.append(13, 'd');
+  EXPECT_EQ(16u, str.size());
+  EXPECT_EQ('\0', str.c_str()[16]);
+  EXPECT_EQ(15u, str.find_last_of("d"));
+  str.clear();
+  EXPECT_TRUE(str.empty());
+
+  using large = basic_inplace_string<char, 1000, std::char_traits<char>, size_in_front_policy>;
+  static_assert(sizeof(large) == 1003);
+  large l{"payload"};
+  EXPECT_EQ("payload", l);
+  EXPECT_EQ(reinterpret_cast<const char*>(&l) + 2, l.data());
+}
+
+TEST(inPlaceString, SizeInFront2)
+{
+  using string = basic_inplace_string<char, 300, std::char_traits<char>, padded_size_in_front_policy>;
+  string str{"abcdef"};
+  str.resize(3);
+  EXPECT_EQ(string{"abc"}, str);
+  EXPECT_NE(string(std::string_view{"abc\0", 4}), str);
+  EXPECT_EQ(std::hash<string>{}(string{"abc"}), std::hash<string>{}(str));
+  EXPECT_NE(std::hash<string>{}(string(std::string_view{"abc\0", 4})), std::hash<string>{}(str));
+
+  padded_inplace_string<300> back{"abc"};
+  back.push_back('\0');
+  EXPECT_NE(padded_inplace_string<300>{"abc"}, back);
+  back.resize(3);
+  EXPECT_EQ(padded_inplace_string<300>{"abc"}, back);
+}
+
+TEST(inPlaceString, Aligned1)
+{
+  static_assert(alignof(aligned_inplace_string<8>) == 16);
+  static_assert(sizeof(aligned_inplace_string<8>) == 16);
+  static_assert(sizeof(aligned_inplace_string<15>) == 16);
+  static_assert(sizeof(aligned_inplace_string<16>) == 32);
+  static_assert(alignof(aligned_inplace_string<63, 64>) == 64);
+  static_assert(sizeof(aligned_inplace_string<63, 64>) == 64);
+  static_assert(sizeof(basic_inplace_string<char32_t, 3, std::char_traits<char32_t>,
+                                            aligned_inplace_string_policy<2>>) == 16);
+
+  struct hot {
+    char c;
+    aligned_inplace_string<63, 64> str;
+  };
+  static_assert(offsetof(hot, str) == 64);
+
+  aligned_inplace_string<15> str{"abcdefghijklmno"};
+  EXPECT_EQ(15u, str.size());
+  EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(str.data()) % 16);
+  EXPECT_STREQ("abcdefghijklmno", str.c_str());
+  EXPECT_EQ(14u, str.find('o'));
+  EXPECT_EQ(0, str.compare("abcdefghijklmno"));
+  EXPECT_LT(str, aligned_inplace_string<15>{"abcdefghijklmnp"});
+  str.resize(3);
+  EXPECT_EQ("abc", str);
+  EXPECT_EQ(std::hash<inplace_string<15>>{}(inplace_string<15>{"abc"}), std::hash<aligned_inplace_string<15>>{}(str));
+}
+
+namespace {
+
+  struct padded_aligned_policy : zero_padded_inplace_string_policy {
+    static constexpr std::size_t alignment = 32;
+  };
+
+}  // namespace
+
+TEST(inPlaceString, Aligned2)
+{
+  using string = basic_inplace_string<char, 20, std::char_traits<char>, padded_aligned_policy>;
+  static_assert(sizeof(string) == 32);
+  string str{"abcdefghij"};
+  str.resize(3);
+  EXPECT_EQ(string{"abc"}, str);
+  EXPECT_NE(string{"abd"}, str);
+  EXPECT_EQ(std::hash<string>{}(string{"abc"}), std::hash<string>{}(str));
+}
+
+TEST(inPlaceString, WideStrings1)
+{
+  inplace_u16string<40> a{u"abcdefghijklmnopqrstuvwxyz\u0141"};
+  inplace_u16string<40> b{u"abcdefghijklmnopqrstuvwxyz\u0041"};  // differs only in the high byte
+  EXPECT_GT(a.compare(b), 0);
+  EXPECT_LT(b.compare(a), 0);
+  EXPECT_NE(a, b);
+  EXPECT_EQ(26u, a.find(u'\u0141'));
+  EXPECT_EQ(std::u16string_view::npos, b.find(u'\u0141'));
+  EXPECT_EQ(26u, b.find(u'A'));
+  EXPECT_EQ(26u, a.find_first_not_of(u"abcdefghijklmnopqrstuvwxyz"));
+  EXPECT_NE(std::hash<inplace_u16string<40>>{}(a), std::hash<inplace_u16string<40>>{}(b));
+
+  inplace_u32string<20> c{U"\U0001F600 smile \U0001F600"};
+  EXPECT_EQ(9u, c.size());
+  EXPECT_EQ(8u, c.rfind(U'\U0001F600'));
+  EXPECT_EQ(std::u32string_view::npos, c.find(U'\U0000F600'));
+  EXPECT_LT(c.compare(U"\U0001F601"), 0);
+  EXPECT_EQ(c, inplace_u32string<20>{c});
+}
+
+static_assert(std::is_trivially_copyable<inplace_string<8>>::value);
+static_assert(std::is_trivially_destructible<inplace_string<8>>::value);
+static_assert(is_trivially_relocatable_v<inplace_string<8>>);
+static_assert(is_trivially_relocatable_v<padded_inplace_string<300>>);
+static_assert(is_trivially_relocatable_v<aligned_inplace_string<20>>);
+static_assert(is_trivially_relocatable_v<inplace_u32string<20>>);
+static_assert(!is_trivially_relocatable_v<std::string>);
+static_assert(!std::is_convertible<uninitialized_t, inplace_string<8>>::value);
+
+TEST(inPlaceString, Uninitialized1)
+{
+  inplace_string<8> str{uninitialized};
+  str = "abc";
+  EXPECT_EQ("abc", str);
+
+  padded_inplace_string<8> padded{uninitialized};
+  EXPECT_TRUE(padded.empty());
+  EXPECT_EQ(padded_inplace_string<8>{}, padded);
+}
+
+TEST(inPlaceString, UninitializedArray1)
+{
+  uninitialized_inplace_array<15> empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(empty.begin(), empty.end());
+
+  uninitialized_inplace_array<15> array(1000);
+  EXPECT_EQ(1000u, array.size());
+  for(std::size_t i = 0; i < array.size(); ++i) array[i] = std::to_string(i);
+  auto moved = std::move(array);
+  EXPECT_TRUE(array.empty());
+  EXPECT_EQ(1000, moved.end() - moved.begin());
+  for(std::size_t i = 0; i < moved.size(); ++i) EXPECT_EQ(std::to_string(i), moved[i]);
+}
+
+namespace {
+
+  struct bounded_copy_back_policy : default_inplace_string_policy {
+    static constexpr inplace_string_copy copy = inplace_string_copy::bounded;
+  };
+
+  template<typename Str>
+  void check_bounded_copy()
+  {
+    using char_type = typename Str::value_type;
+    const auto max_size = Str{}.max_size();
+    for(std::size_t length = 0; length <= max_size; length += std::max<std::size_t>(1, max_size / 37)) {
+      std::basic_string<char_type> text(length, char_type{'a'});
+      for(std::size_t i = 0; i < length; ++i) text[i] = static_cast<char_type>('a' + i % 26);
+      const Str src{std::basic_string_view<char_type>{text}};
+
+      const Str copy{src};
+      EXPECT_EQ(length, copy.size());
+      EXPECT_EQ(src, copy);
+      EXPECT_EQ(char_type{}, copy.c_str()[length]);
+
+      Str assigned{std::basic_string<char_type>(max_size, char_type{'z'})};
+      assigned = src;
+      EXPECT_EQ(src, assigned);
+      EXPECT_EQ(char_type{}, assigned.c_str()[length]);
+      const auto& self = assigned;
+      assigned = self;
+      EXPECT_EQ(src, assigned);
+
+      Str other{std::basic_string<char_type>(max_size / 2, char_type{'y'})};
+      const Str other_copy{other};
+      using std::swap;
+      swap(assigned, other);
+      EXPECT_EQ(src, other);
+      EXPECT_EQ(other_copy, assigned);
+    }
+  }
+
+}  // namespace
+
+static_assert(!std::is_trivially_copyable<bounded_copy_inplace_string<100>>::value);
+static_assert(is_trivially_relocatable_v<bounded_copy_inplace_string<100>>);
+static_assert(sizeof(bounded_copy_inplace_string<100>) ==
+              sizeof(basic_inplace_string<char, 100, std::char_traits<char>, size_in_front_policy>));
+
+TEST(inPlaceString, BoundedCopy1)
+{
+  const bounded_copy_inplace_string<200> str{"abc"};
+  auto copy = str;
+  EXPECT_EQ("abc", copy);
+  copy.append(100, 'x');
+  EXPECT_EQ(103u, copy.size());
+  EXPECT_EQ(3u, str.size());
+  copy = str;
+  EXPECT_EQ(str, copy);
+}
+
+TEST(inPlaceString, BoundedCopy2)
+{
+  check_bounded_copy<bounded_copy_inplace_string<8>>();
+  check_bounded_copy<bounded_copy_inplace_string<63>>();
+  check_bounded_copy<bounded_copy_inplace_string<100>>();
+  check_bounded_copy<bounded_copy_inplace_string<1000>>();
+  check_bounded_copy<basic_inplace_string<char, 100, std::char_traits<char>, bounded_copy_back_policy>>();
+  check_bounded_copy<basic_inplace_string<char, 300, std::char_traits<char>, bounded_copy_back_policy>>();
+  check_bounded_copy<basic_inplace_string<char16_t, 90, std::char_traits<char16_t>, bounded_copy_back_policy>>();
+  check_bounded_copy<basic_inplace_string<char32_t, 90, std::char_traits<char32_t>,
+                                          bounded_copy_inplace_string_policy>>();
+}
+
+namespace {
+
+  template<typename Int>
+  void check_append_int(Int value)
+  {
+    for(unsigned base : {2u, 8u, 10u, 16u, 36u}) {
+      char buf[130];
+      const auto res = std::to_chars(std::begin(buf), std::end(buf), value, static_cast<int>(base));
+      const std::string_view expected{buf, static_cast<std::size_t>(res.ptr - buf)};
+
+      inplace_string<200> str{"x="};
+      inplace_string_result r;
+      if constexpr(std::is_signed_v<Int>)
+        r = str.append_int(value, 0, '0', base);
+      else
+        r = str.append_uint(value, 0, '0', base);
+      EXPECT_TRUE(r);
+      EXPECT_EQ(expected.size(), r.count);
+      EXPECT_EQ("x=" + std::string{expected}, str) << "base " << base;
+    }
+  }
+
+  template<typename Int>
+  void check_append_int_limits()
+  {
+    check_append_int(std::numeric_limits<Int>::min());
+    check_append_int(std::numeric_limits<Int>::max());
+    check_append_int(static_cast<Int>(std::numeric_limits<Int>::min() + 1));
+    check_append_int(static_cast<Int>(std::numeric_limits<Int>::max() - 1));
+    check_append_int(Int{0});
+    check_append_int(Int{1});
+    if constexpr(std::is_signed_v<Int>) check_append_int(Int{-1});
+    for(Int v = 1; v <= std::numeric_limits<Int>::max() / 10; v = static_cast<Int>(v * 10)) {
+      check_append_int(static_cast<Int>(v - 1));
+      check_append_int(v);
+      check_append_int(static_cast<Int>(v + 1));
+      if constexpr(std::is_signed_v<Int>) check_append_int(static_cast<Int>(-v));
+    }
+  }
+
+}  // namespace
+
+TEST(inPlaceString, AppendInt1)
+{
+  inplace_string<32> str;
+  EXPECT_TRUE(str.append_int(-42));
+  str += '|';
+  str.append_uint(7u, 3);
+  str += '|';
+  str.append_int(-7, 4);
+  str += '|';
+  str.append_int(-7, 4, ' ');
+  str += '|';
+  str.append_uint(255u, 4, '*', 16);
+  str += '|';
+  str.append_int(12345, 2);
+  EXPECT_EQ("-42|007|-007|  -7|**ff|12345", str);
+  EXPECT_EQ(28u, str.size());
+}
+
+TEST(inPlaceString, AppendInt2)
+{
+  check_append_int_limits<signed char>();
+  check_append_int_limits<unsigned char>();
+  check_append_int_limits<short>();
+  check_append_int_limits<unsigned short>();
+  check_append_int_limits<int>();
+  check_append_int_limits<unsigned>();
+  check_append_int_limits<long long>();
+  check_append_int_limits<unsigned long long>();
+  check_append_int_limits<std::int64_t>();
+  check_append_int_limits<std::uint64_t>();
+}
+
+TEST(inPlaceString, AppendIntOverflow)
+{
+  inplace_string<8> str{"abcde"};
+  EXPECT_THROW(str.append_int(-1000), std::length_error);
+  EXPECT_EQ("abcde", str);
+  EXPECT_THROW(str.append_uint(1u, 4), std::length_error);
+  EXPECT_TRUE(str.append_int(-10));
+  EXPECT_EQ("abcde-10", str);
+
+  basic_inplace_string<char, 8, std::char_traits<char>, overflow_policy<inplace_string_overflow::truncate>> truncating{
+      "abcde"};
+  const auto r = truncating.append_uint(1234u);
+  EXPECT_FALSE(r);
+  EXPECT_EQ(std::errc::value_too_large, r.ec);
+  EXPECT_EQ(0u, r.count);
+  EXPECT_EQ("abcde", truncating);
+  EXPECT_TRUE(truncating.append_uint(123u));
+  EXPECT_EQ("abcde123", truncating);
+}
+
+TEST(inPlaceString, AppendIntWide)
+{
+  inplace_wstring<24> str{L"n="};
+  str.append_int(-123456789);
+  str.append_uint(0xBEEFu, 6, L'0', 16);
+  EXPECT_EQ(L"n=-12345678900beef", str);
+}
+
+#if defined(MP_INPLACE_STRING_FLOAT_TO_CHARS)
+
+namespace {
+
+  template<typename Float, typename... Args>
+  void check_append_float(Float value, Args... args)
+  {
+    char buf[1100];
+    const auto res = std::to_chars(std::begin(buf), std::end(buf), value, args...);
+    const std::string_view expected{buf, static_cast<std::size_t>(res.ptr - buf)};
+
+    inplace_string<1100> str{"v="};
+    const auto r = str.append_float(value, args...);
+    EXPECT_TRUE(r);
+    EXPECT_EQ(expected.size(), r.count);
+    EXPECT_EQ("v=" + std::string{expected}, str);
+
+    inplace_u32string<1100> wide{U"v="};
+    EXPECT_TRUE(wide.append_float(value, args...));
+    EXPECT_EQ(str.size(), wide.size());
+    EXPECT_TRUE(std::equal(str.begin(), str.end(), wide.begin(), wide.end(),
+                           [](char c, char32_t w) { return static_cast<char32_t>(c) == w; }));
+  }
+
+}  // namespace
+
+TEST(inPlaceString, AppendFloat1)
+{
+  inplace_string<64> str;
+  str.append_float(101.25);
+  str += '|';
+  str.append_float(0.1f);
+  str += '|';
+  str.append_float(1.5, std::chars_format::fixed, 3);
+  str += '|';
+  str.append_float(12345.678, std::chars_format::scientific, 2);
+  str += '|';
+  str.append_float(1e21, std::chars_format::fixed);
+  str += '|';
+  str.append_float(-0.0);
+  EXPECT_EQ("101.25|0.1|1.500|1.23e+04|1000000000000000000000|-0", str);
+}
+
+TEST(inPlaceString, AppendFloat2)
+{
+  for(double v : {0.0, 1.0, -1.0, 0.1, 1.0 / 3, 123456789.125, 1e-310, std::numeric_limits<double>::max(),
+                  std::numeric_limits<double>::min(), std::numeric_limits<double>::infinity(),
+                  -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN()}) {
+    check_append_float(v);
+    check_append_float(v, std::chars_format::fixed);
+    check_append_float(v, std::chars_format::scientific);
+    check_append_float(v, std::chars_format::general);
+    check_append_float(v, std::chars_format::hex);
+    check_append_float(v, std::chars_format::fixed, 2);
+    check_append_float(v, std::chars_format::scientific, 10);
+    check_append_float(v, std::chars_format::general, 0);
+    check_append_float(static_cast<float>(v));
+  }
+}
+
+TEST(inPlaceString, AppendFloatOverflow)
+{
+  inplace_string<8> str{"abc"};
+  EXPECT_THROW(str.append_float(1.0 / 3), std::length_error);
+  EXPECT_EQ("abc", str);
+  EXPECT_STREQ("abc", str.c_str());
+  EXPECT_TRUE(str.append_float(-1.25));
+  EXPECT_EQ("abc-1.25", str);
+
+  basic_inplace_string<char, 8, std::char_traits<char>, mp::zero_padded_inplace_string_policy> padded{"abc"};
+  EXPECT_THROW(padded.append_float(1e100, std::chars_format::fixed), std::length_error);
+  EXPECT_EQ((padded_inplace_string<8>{"abc"}), padded);
+
+  basic_inplace_string<char16_t, 8, std::char_traits<char16_t>, overflow_policy<inplace_string_overflow::truncate>>
+      wide{u"abc"};
+  const auto r = wide.append_float(0.125, std::chars_format::fixed, 4);
+  EXPECT_EQ(std::errc::value_too_large, r.ec);
+  EXPECT_EQ(0u, r.count);
+  EXPECT_EQ(u"abc", wide);
+  EXPECT_EQ(3u, std::char_traits<char16_t>::length(wide.c_str()));
+  EXPECT_TRUE(wide.append_float(0.125));
+  EXPECT_EQ(u"abc0.125", wide);
+
+  // the narrow characters fit in the free bytes but not in the free characters
+  basic_inplace_string<char16_t, 4, std::char_traits<char16_t>, overflow_policy<inplace_string_overflow::truncate>>
+      empty;
+  EXPECT_EQ(std::errc::value_too_large, empty.append_float(1234567.0).ec);
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(char16_t{}, empty.c_str()[0]);
+  basic_inplace_string<char16_t, 4, std::char_traits<char16_t>,
+                       overflow_policy<inplace_string_overflow::throw_exception>>
+      throwing{u"a"};
+  EXPECT_THROW(throwing.append_float(12345.0), std::length_error);
+  EXPECT_EQ(u"a", throwing);
+  EXPECT_EQ(1u, std::char_traits<char16_t>::length(throwing.c_str()));
+}
+
+#endif
+
+namespace {
+
+  template<typename T>
+  bool same_value(T lhs, T rhs)
+  {
+    if constexpr(std::is_floating_point_v<T>)
+      if(std::isnan(lhs)) return std::isnan(rhs);
+    return lhs == rhs && std::signbit(static_cast<double>(lhs)) == std::signbit(static_cast<double>(rhs));
+  }
+
+  template<typename T, typename... Args>
+  void check_from_chars(std::string_view text, Args... args)
+  {
+    T expected{};
+    const auto res = std::from_chars(text.data(), text.data() + text.size(), expected, args...);
+    const auto expected_count =
+        res.ec == std::errc::invalid_argument ? 0 : static_cast<std::size_t>(res.ptr - text.data());
+
+    T value{};
+    const inplace_string<64> str{text};
+    const auto r = str.from_chars(value, args...);
+    EXPECT_EQ(res.ec, r.ec) << text;
+    EXPECT_EQ(expected_count, r.count) << text;
+    if(res.ec == std::errc{}) {
+      EXPECT_TRUE(same_value(expected, value)) << text;
+    }
+
+    const std::u16string wide(text.begin(), text.end());
+    const basic_inplace_string<char16_t, 64> wide_str{std::u16string_view{wide}};
+    T wide_value{};
+    const auto wide_r = wide_str.from_chars(wide_value, args...);
+    EXPECT_EQ(res.ec, wide_r.ec) << text;
+    EXPECT_EQ(expected_count, wide_r.count) << text;
+    if(res.ec == std::errc{}) {
+      EXPECT_TRUE(same_value(expected, wide_value)) << text;
+    }
+  }
+
+  template<typename Int>
+  void check_from_chars_int(std::string_view text)
+  {
+    for(int base : {2, 8, 10, 16, 36}) check_from_chars<Int>(text, base);
+  }
+
+}  // namespace
+
+TEST(inPlaceString, FromChars1)
+{
+  const inplace_string<32> str{"12345678901234|x"};
+  long long v = 0;
+  const auto r = str.from_chars(v);
+  EXPECT_TRUE(r);
+  EXPECT_EQ(14u, r.count);
+  EXPECT_EQ(12345678901234, v);
+
+  EXPECT_EQ(-42, inplace_string<8>{"-42"}.parse<int>().value);
+  EXPECT_EQ(255u, inplace_string<8>{"ff"}.parse<unsigned>(16).value);
+  EXPECT_EQ(std::errc::invalid_argument, inplace_string<8>{"42 "}.parse<int>().ec);
+  EXPECT_EQ(std::errc::invalid_argument, inplace_string<8>{""}.parse<int>().ec);
+  EXPECT_EQ(std::errc::invalid_argument, inplace_string<8>{"+1"}.parse<int>().ec);
+  EXPECT_EQ(std::errc::invalid_argument, inplace_string<8>{"-1"}.parse<unsigned>().ec);
+  EXPECT_EQ(std::errc::result_out_of_range, inplace_string<8>{"256"}.parse<std::uint8_t>().ec);
+  EXPECT_FALSE(inplace_string<8>{"256"}.parse<std::uint8_t>());
+  EXPECT_EQ(-128, inplace_string<8>{"-128"}.parse<std::int8_t>().value);
+}
+
+TEST(inPlaceString, FromCharsCrossCheck)
+{
+  std::vector<std::string> texts{"", "-", "0", "-0", "00000000000000000000000000001", "9", "12345678", "123456789",
+                                 "1234567812345678", "18446744073709551615", "18446744073709551616",
+                                 "9223372036854775807", "9223372036854775808", "-9223372036854775808",
+                                 "-9223372036854775809", "99999999999999999999999", "2147483648", "-2147483649",
+                                 "ffffFFFF", "zz", "1_000", "12345678a", "1234567\0", "-+1", "0x10"};
+  std::mt19937 gen(1);
+  for(int i = 0; i < 300; ++i) {
+    std::string text(std::uniform_int_distribution<std::size_t>(1, 30)(gen), '0');
+    for(auto& c : text) c = static_cast<char>('0' + std::uniform_int_distribution<int>(0, 9)(gen));
+    if(i % 3 == 0) text[0] = '-';
+    if(i % 7 == 0) text[text.size() / 2] = 'x';
+    texts.push_back(text);
+  }
+  for(const auto& text : texts) {
+    check_from_chars_int<signed char>(text);
+    check_from_chars_int<unsigned char>(text);
+    check_from_chars_int<short>(text);
+    check_from_chars_int<int>(text);
+    check_from_chars_int<unsigned>(text);
+    check_from_chars_int<long long>(text);
+    check_from_chars_int<unsigned long long>(text);
+  }
+}
+
+#if defined(MP_INPLACE_STRING_FLOAT_TO_CHARS)
+
+TEST(inPlaceString, FromCharsFloat1)
+{
+  EXPECT_EQ(101.25, inplace_string<16>{"101.25"}.parse<double>().value);
+  EXPECT_EQ(-0.5f, inplace_string<16>{"-5e-1"}.parse<float>().value);
+  EXPECT_EQ(1e300, inplace_string<16>{"1e300"}.parse<double>().value);
+  EXPECT_EQ(0x1.8p1, inplace_string<16>{"1.8p1"}.parse<double>(std::chars_format::hex).value);
+  EXPECT_EQ(std::errc::invalid_argument, inplace_string<16>{"1.5x"}.parse<double>().ec);
+  EXPECT_EQ(std::errc::result_out_of_range, inplace_string<16>{"1e999"}.parse<double>().ec);
+
+  const inplace_string<16> str{"3.5e2|"};
+  double v = 0;
+  const auto r = str.from_chars(v);
+  EXPECT_TRUE(r);
+  EXPECT_EQ(5u, r.count);
+  EXPECT_EQ(350.0, v);
+}
+
+TEST(inPlaceString, FromCharsFloatCrossCheck)
+{
+  std::vector<std::string> texts{"0", "-0", "0.0", "-0.000", ".5", "5.", ".", "-.", "1e", "1e+", "1e-5", "1E5",
+                                 "1.5e22", "1e23", "9007199254740992", "9007199254740993", "123456789012345678",
+                                 "1234567890123456789", "12345678901234567890", "0.1", "0.30000000000000004",
+                                 "3.4028235e38", "1e-400", "1e400", "inf", "-infinity", "nan", "NaN(123)", "0x1p3",
+                                 "1.7976931348623157e308", "4.9e-324", "00000000000000000000000001.5", "1e0001",
+                                 "0.0000000000000000000000000000012345", "16777217", "2.5e-10", "1.5e10", "1.5e11"};
+  std::mt19937 gen(2);
+  for(int i = 0; i < 1000; ++i) {
+    std::string text;
+    if(i % 2) text += '-';
+    const auto digits = std::uniform_int_distribution<int>(1, 20)(gen);
+    for(int d = 0; d < digits; ++d) text += static_cast<char>('0' + std::uniform_int_distribution<int>(0, 9)(gen));
+    if(i % 3) text.insert(std::uniform_int_distribution<std::size_t>(0, text.size())(gen), ".");
+    if(i % 4 == 0) text += "e" + std::to_string(std::uniform_int_distribution<int>(-30, 30)(gen));
+    texts.push_back(text);
+  }
+  for(const auto& text : texts) {
+    check_from_chars<double>(text);
+    check_from_chars<float>(text);
+    check_from_chars<double>(text, std::chars_format::fixed);
+    check_from_chars<double>(text, std::chars_format::scientific);
+  }
+}
+
+#endif
+
+#if __cplusplus > 201703L
+
+TEST(inPlaceString, HashCompileTime)
+{
+  constexpr auto h = std::hash<inplace_string<32>>{}(inplace_string<32>{"compile-time key"});
+  EXPECT_EQ(h, std::hash<inplace_string<32>>{}(inplace_string<32>{"compile-time key"}));
+  constexpr auto h2 = std::hash<inplace_string<128>>{}(inplace_string<128>{std::string_view{
+      "a long compile-time key that needs more than sixty-four bytes to be hashed by the kernel"}});
+  EXPECT_EQ(h2, std::hash<inplace_string<128>>{}(inplace_string<128>{std::string_view{
+                    "a long compile-time key that needs more than sixty-four bytes to be hashed by the kernel"}}));
+}
+
+#endif